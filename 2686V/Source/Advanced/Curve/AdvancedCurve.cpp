@@ -1,4 +1,5 @@
 ﻿#include <cmath>
+#include <cstring>
 #include <algorithm>
 
 #include "./AdvancedCurve.h"
@@ -9,28 +10,28 @@ inline float mapRange(float val, float inMin, float inMax, float outMin, float o
 	return outMin + (val - inMin) * (outMax - outMin) / (inMax - inMin);
 }
 
-CurveCore::CurveCore() {
+namespace {
 	// -------------------------------------------------------------
 	// 1. 基本となる数学関数群
 	// -------------------------------------------------------------
-	auto calcLinear = [](float x) { return x; };
+	float calcLinear(float x) { return x; }
 
-	auto calcArcExp = [](float x) { return 1.0f - std::sqrt(1.0f - std::pow(x, 2.0f)); };
+	float calcArcExp(float x) { return 1.0f - std::sqrt(1.0f - std::pow(x, 2.0f)); }
 
-	auto calcArcLog = [](float x) { return std::sqrt(1.0f - std::pow(1.0f - x, 2.0f)); };
+	float calcArcLog(float x) { return std::sqrt(1.0f - std::pow(1.0f - x, 2.0f)); }
 
-	auto calcExp = [](float x, float rate) {
+	float calcExp(float x, float rate) {
 		if (std::abs(rate) < 0.001f) return x;
 		return (std::exp(rate * x) - 1.0f) / (std::exp(rate) - 1.0f);
-		};
+	}
 
-	auto calcLog = [](float x, float rate) {
+	float calcLog(float x, float rate) {
 		if (std::abs(rate) < 0.001f) return x;
 		return std::log(1.0f + rate * x) / std::log(1.0f + rate);
-		};
+	}
 
 	// 1点スプライン (二次ベジェ曲線の厳密解)
-	auto calcSp1 = [](float x, float cx, float cy) {
+	float calcSp1(float x, float cx, float cy) {
 		if (x <= 0.0f) return 0.0f;
 		if (x >= 1.0f) return 1.0f;
 		float t = x;
@@ -46,10 +47,10 @@ CurveCore::CurveCore() {
 		}
 		t = std::clamp(t, 0.0f, 1.0f);
 		return (1.0f - t) * (1.0f - t) * 0.0f + 2.0f * (1.0f - t) * t * cy + t * t * 1.0f;
-		};
+	}
 
 	// 2点スプライン (三次ベジェ曲線の近似解)
-	auto calcSp2 = [](float x, float cx1, float cy1, float cx2, float cy2) -> float {
+	float calcSp2(float x, float cx1, float cy1, float cx2, float cy2) {
 		if (x <= 0.0001f) return 0.0f;
 		if (x >= 0.9999f) return 1.0f;
 
@@ -75,81 +76,81 @@ CurveCore::CurveCore() {
 
 		float mt = 1.0f - t;
 		return 3.0f * mt * mt * t * cy1 + 3.0f * mt * t * t * cy2 + t * t * t;
-		};
+	}
 
 	// -------------------------------------------------------------
-	// 2. ロジックごとの関数マッピング
+	// 2. ロジックごとの関数 (prm: 焼き込むスロットのパラメータ)
 	// -------------------------------------------------------------
-	logics[CurveParams::Logic::Linear] = [=](int pIdx, int tIdx, int prmIdx, float x) {
+	float logicLinear(const BaseCurveParams&, float x) {
 		return calcLinear(x);
-		};
+	}
 
-	logics[CurveParams::Logic::ArcExp] = [=](int pIdx, int tIdx, int prmIdx, float x) {
+	float logicArcExp(const BaseCurveParams&, float x) {
 		return calcArcExp(x);
-		};
+	}
 
-	logics[CurveParams::Logic::ArcLog] = [=](int pIdx, int tIdx, int prmIdx, float x) {
+	float logicArcLog(const BaseCurveParams&, float x) {
 		return calcArcLog(x);
-		};
+	}
 
-	logics[CurveParams::Logic::Exp] = [this, calcExp](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].expCurve;
-		float k = m_params.params[pIdx][tIdx][prmIdx].k;
+	float logicExp(const BaseCurveParams& prm, float x) {
+		auto& p = prm.expCurve;
+		float k = prm.k;
 		return calcExp(x, p.rate * k); // ★kを適用
-		};
+	}
 
-	logics[CurveParams::Logic::Log] = [this, calcLog](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].logCurve;
-		float k = m_params.params[pIdx][tIdx][prmIdx].k;
+	float logicLog(const BaseCurveParams& prm, float x) {
+		auto& p = prm.logCurve;
+		float k = prm.k;
 		return calcLog(x, p.rate * k); // ★kを適用
-		};
+	}
 
-	logics[CurveParams::Logic::Sp1] = [this, calcSp1](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].sp1Curve;
+	float logicSp1(const BaseCurveParams& prm, float x) {
+		auto& p = prm.sp1Curve;
 		return calcSp1(x, p.cp1.x, p.cp1.y);
-		};
+	}
 
-	logics[CurveParams::Logic::Sp2] = [this, calcSp2](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].sp2Curve;
+	float logicSp2(const BaseCurveParams& prm, float x) {
+		auto& p = prm.sp2Curve;
 		return calcSp2(x, p.cp1.x, p.cp1.y, p.cp2.x, p.cp2.y);
-		};
+	}
 
-	logics[CurveParams::Logic::LinearArcExp] = [this, calcLinear, calcArcExp](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear1ArcExp;
+	float logicLinearArcExp(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear1ArcExp;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 		if (x <= px1) return mapRange(calcLinear(mapRange(x, 0.0f, px1, 0.0f, 1.0f)), 0.0f, 1.0f, 0.0f, py1);
 		else         return mapRange(calcArcExp(mapRange(x, px1, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py1, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::LinearArcLog] = [this, calcLinear, calcArcLog](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear1ArcLog;
+	float logicLinearArcLog(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear1ArcLog;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 		if (x <= px1) return mapRange(calcLinear(mapRange(x, 0.0f, px1, 0.0f, 1.0f)), 0.0f, 1.0f, 0.0f, py1);
 		else         return mapRange(calcArcLog(mapRange(x, px1, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py1, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::LinearExp] = [this, calcLinear, calcExp](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear1Exp;
-		float k = m_params.params[pIdx][tIdx][prmIdx].k;
+	float logicLinearExp(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear1Exp;
+		float k = prm.k;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 		if (x <= px1) return mapRange(calcLinear(mapRange(x, 0.0f, px1, 0.0f, 1.0f)), 0.0f, 1.0f, 0.0f, py1);
 		else         return mapRange(calcExp(mapRange(x, px1, 1.0f, 0.0f, 1.0f), p.rate * k), 0.0f, 1.0f, py1, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::LinearLog] = [this, calcLinear, calcLog](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear1Log;
-		float k = m_params.params[pIdx][tIdx][prmIdx].k;
+	float logicLinearLog(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear1Log;
+		float k = prm.k;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 		if (x <= px1) return mapRange(calcLinear(mapRange(x, 0.0f, px1, 0.0f, 1.0f)), 0.0f, 1.0f, 0.0f, py1);
 		else         return mapRange(calcLog(mapRange(x, px1, 1.0f, 0.0f, 1.0f), p.rate * k), 0.0f, 1.0f, py1, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::LinearSp1] = [this, calcLinear, calcSp1](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear1Sp1;
+	float logicLinearSp1(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear1Sp1;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 		if (x <= px1) {
@@ -161,10 +162,10 @@ CurveCore::CurveCore() {
 			float localCY = mapRange(p.cp1.y, py1, 1.0f, 0.0f, 1.0f);
 			return mapRange(calcSp1(mapRange(x, px1, 1.0f, 0.0f, 1.0f), localCX, localCY), 0.0f, 1.0f, py1, 1.0f);
 		}
-		};
+	}
 
-	logics[CurveParams::Logic::LinearSp2] = [this, calcLinear, calcSp2](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear1Sp2;
+	float logicLinearSp2(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear1Sp2;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 		if (x <= px1) {
@@ -177,44 +178,44 @@ CurveCore::CurveCore() {
 			float localCY2 = mapRange(p.cp2.y, py1, 1.0f, 0.0f, 1.0f);
 			return mapRange(calcSp2(mapRange(x, px1, 1.0f, 0.0f, 1.0f), localCX1, localCY1, localCX2, localCY2), 0.0f, 1.0f, py1, 1.0f);
 		}
-		};
+	}
 
-	logics[CurveParams::Logic::ArcExpLinear] = [this, calcLinear, calcArcExp](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].arcExpLinear1;
+	float logicArcExpLinear(const BaseCurveParams& prm, float x) {
+		auto& p = prm.arcExpLinear1;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 		if (x <= px1) return mapRange(calcArcExp(mapRange(x, 0.0f, px1, 0.0f, 1.0f)), 0.0f, 1.0f, 0.0f, py1);
 		else         return mapRange(calcLinear(mapRange(x, px1, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py1, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::ArcLogLinear] = [this, calcLinear, calcArcLog](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].arcLogLinear1;
+	float logicArcLogLinear(const BaseCurveParams& prm, float x) {
+		auto& p = prm.arcLogLinear1;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 		if (x <= px1) return mapRange(calcArcLog(mapRange(x, 0.0f, px1, 0.0f, 1.0f)), 0.0f, 1.0f, 0.0f, py1);
 		else         return mapRange(calcLinear(mapRange(x, px1, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py1, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::ExpLinear] = [this, calcLinear, calcExp](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].expLinear1;
-		float k = m_params.params[pIdx][tIdx][prmIdx].k;
+	float logicExpLinear(const BaseCurveParams& prm, float x) {
+		auto& p = prm.expLinear1;
+		float k = prm.k;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 		if (x <= px1) return mapRange(calcExp(mapRange(x, 0.0f, px1, 0.0f, 1.0f), p.rate * k), 0.0f, 1.0f, 0.0f, py1);
 		else         return mapRange(calcLinear(mapRange(x, px1, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py1, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::LogLinear] = [this, calcLinear, calcLog](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].logLinear1;
-		float k = m_params.params[pIdx][tIdx][prmIdx].k;
+	float logicLogLinear(const BaseCurveParams& prm, float x) {
+		auto& p = prm.logLinear1;
+		float k = prm.k;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 		if (x <= px1) return mapRange(calcLog(mapRange(x, 0.0f, px1, 0.0f, 1.0f), p.rate * k), 0.0f, 1.0f, 0.0f, py1);
 		else         return mapRange(calcLinear(mapRange(x, px1, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py1, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::Sp1Linear] = [this, calcLinear, calcSp1](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].sp1Linear1;
+	float logicSp1Linear(const BaseCurveParams& prm, float x) {
+		auto& p = prm.sp1Linear1;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 		if (x <= px1) {
@@ -225,10 +226,10 @@ CurveCore::CurveCore() {
 		else {
 			return mapRange(calcLinear(mapRange(x, px1, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py1, 1.0f);
 		}
-		};
+	}
 
-	logics[CurveParams::Logic::Sp2Linear] = [this, calcLinear, calcSp2](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].sp2Linear1;
+	float logicSp2Linear(const BaseCurveParams& prm, float x) {
+		auto& p = prm.sp2Linear1;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 		if (x <= px1) {
@@ -241,10 +242,10 @@ CurveCore::CurveCore() {
 		else {
 			return mapRange(calcLinear(mapRange(x, px1, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py1, 1.0f);
 		}
-		};
+	}
 
-	logics[CurveParams::Logic::Linear2ArcExp] = [this, calcLinear, calcArcExp](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear2ArcExp;
+	float logicLinear2ArcExp(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear2ArcExp;
 		// ユーザー操作による破綻を防ぐため、px1とpx2の順序を補正
 		float px1 = std::min(p.pos1.x, p.pos2.x);
 		float px2 = std::max(p.pos1.x, p.pos2.x);
@@ -254,10 +255,10 @@ CurveCore::CurveCore() {
 		if (x <= px1) return mapRange(calcLinear(mapRange(x, 0.0f, px1, 0.0f, 1.0f)), 0.0f, 1.0f, 0.0f, py1);
 		else if (x <= px2) return mapRange(calcArcExp(mapRange(x, px1, px2, 0.0f, 1.0f)), 0.0f, 1.0f, py1, py2);
 		else return mapRange(calcLinear(mapRange(x, px2, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py2, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::Linear2ArcLog] = [this, calcLinear, calcArcLog](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear2ArcLog;
+	float logicLinear2ArcLog(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear2ArcLog;
 		float px1 = std::min(p.pos1.x, p.pos2.x);
 		float px2 = std::max(p.pos1.x, p.pos2.x);
 		float py1 = (p.pos1.x <= p.pos2.x) ? p.pos1.y :
@@ -266,11 +267,11 @@ CurveCore::CurveCore() {
 		if (x <= px1) return mapRange(calcLinear(mapRange(x, 0.0f, px1, 0.0f, 1.0f)), 0.0f, 1.0f, 0.0f, py1);
 		else if (x <= px2) return mapRange(calcArcLog(mapRange(x, px1, px2, 0.0f, 1.0f)), 0.0f, 1.0f, py1, py2);
 		else return mapRange(calcLinear(mapRange(x, px2, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py2, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::Linear2Exp] = [this, calcLinear, calcExp](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear2Exp;
-		float k = m_params.params[pIdx][tIdx][prmIdx].k;
+	float logicLinear2Exp(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear2Exp;
+		float k = prm.k;
 		float px1 = std::min(p.pos1.x, p.pos2.x);
 		float px2 = std::max(p.pos1.x, p.pos2.x);
 		float py1 = (p.pos1.x <= p.pos2.x) ? p.pos1.y : p.pos2.y;
@@ -279,11 +280,11 @@ CurveCore::CurveCore() {
 		if (x <= px1) return mapRange(calcLinear(mapRange(x, 0.0f, px1, 0.0f, 1.0f)), 0.0f, 1.0f, 0.0f, py1);
 		else if (x <= px2) return mapRange(calcExp(mapRange(x, px1, px2, 0.0f, 1.0f), p.rate * k), 0.0f, 1.0f, py1, py2);
 		else return mapRange(calcLinear(mapRange(x, px2, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py2, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::Linear2Log] = [this, calcLinear, calcLog](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear2Log;
-		float k = m_params.params[pIdx][tIdx][prmIdx].k;
+	float logicLinear2Log(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear2Log;
+		float k = prm.k;
 		float px1 = std::min(p.pos1.x, p.pos2.x);
 		float px2 = std::max(p.pos1.x, p.pos2.x);
 		float py1 = (p.pos1.x <= p.pos2.x) ? p.pos1.y : p.pos2.y;
@@ -292,10 +293,10 @@ CurveCore::CurveCore() {
 		if (x <= px1) return mapRange(calcLinear(mapRange(x, 0.0f, px1, 0.0f, 1.0f)), 0.0f, 1.0f, 0.0f, py1);
 		else if (x <= px2) return mapRange(calcLog(mapRange(x, px1, px2, 0.0f, 1.0f), p.rate * k), 0.0f, 1.0f, py1, py2);
 		else return mapRange(calcLinear(mapRange(x, px2, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py2, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::Linear2Sp1] = [this, calcLinear, calcSp1](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear2Sp1;
+	float logicLinear2Sp1(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear2Sp1;
 		float px1 = std::min(p.pos1.x, p.pos2.x);
 		float px2 = std::max(p.pos1.x, p.pos2.x);
 		float py1 = (p.pos1.x <= p.pos2.x) ? p.pos1.y : p.pos2.y;
@@ -308,10 +309,10 @@ CurveCore::CurveCore() {
 			return mapRange(calcSp1(mapRange(x, px1, px2, 0.0f, 1.0f), localCX, localCY), 0.0f, 1.0f, py1, py2);
 		}
 		else return mapRange(calcLinear(mapRange(x, px2, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py2, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::Linear2Sp2] = [this, calcLinear, calcSp2](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear2Sp2;
+	float logicLinear2Sp2(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear2Sp2;
 		float px1 = std::min(p.pos1.x, p.pos2.x);
 		float px2 = std::max(p.pos1.x, p.pos2.x);
 		float py1 = (p.pos1.x <= p.pos2.x) ? p.pos1.y : p.pos2.y;
@@ -326,19 +327,19 @@ CurveCore::CurveCore() {
 			return mapRange(calcSp2(mapRange(x, px1, px2, 0.0f, 1.0f), localCX1, localCY1, localCX2, localCY2), 0.0f, 1.0f, py1, py2);
 		}
 		else return mapRange(calcLinear(mapRange(x, px2, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py2, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::Linear2] = [this, calcLinear](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear2;
+	float logicLinear2(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear2;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 
 		if (x <= px1) return mapRange(calcLinear(mapRange(x, 0.0f, px1, 0.0f, 1.0f)), 0.0f, 1.0f, 0.0f, py1);
 		else return mapRange(calcLinear(mapRange(x, px1, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py1, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::Linear3] = [this, calcLinear](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].linear3;
+	float logicLinear3(const BaseCurveParams& prm, float x) {
+		auto& p = prm.linear3;
 		float px1 = std::min(p.pos1.x, p.pos2.x);
 		float px2 = std::max(p.pos1.x, p.pos2.x);
 		float py1 = (p.pos1.x <= p.pos2.x) ? p.pos1.y : p.pos2.y;
@@ -349,10 +350,10 @@ CurveCore::CurveCore() {
 			return mapRange(calcLinear(mapRange(x, px1, px2, 0.0f, 1.0f)), 0.0f, 1.0f, py1, py2);
 		}
 		else return mapRange(calcLinear(mapRange(x, px2, 1.0f, 0.0f, 1.0f)), 0.0f, 1.0f, py2, 1.0f);
-		};
+	}
 
-	logics[CurveParams::Logic::Sprine12] = [this, calcSp1](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].sprine12;
+	float logicSprine12(const BaseCurveParams& prm, float x) {
+		auto& p = prm.sprine12;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 
@@ -366,10 +367,10 @@ CurveCore::CurveCore() {
 			float localCY = mapRange(p.cp1.y, py1, 1.0f, 0.0f, 1.0f);
 			return mapRange(calcSp1(mapRange(x, px1, 1.0f, 0.0f, 1.0f), localCX, localCY), 0.0f, 1.0f, py1, 1.0f);
 		}
-		};
+	}
 
-	logics[CurveParams::Logic::Sprine22] = [this, calcSp2](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].sprine22;
+	float logicSprine22(const BaseCurveParams& prm, float x) {
+		auto& p = prm.sprine22;
 		float px1 = p.pos1.x;
 		float py1 = p.pos1.y;
 
@@ -387,9 +388,9 @@ CurveCore::CurveCore() {
 			float localCY2 = mapRange(p.cp4.y, py1, 1.0f, 0.0f, 1.0f);
 			return mapRange(calcSp2(mapRange(x, px1, 1.0f, 0.0f, 1.0f), localCX1, localCY1, localCX2, localCY2), 0.0f, 1.0f, py1, 1.0f);
 		}
-		};
-	logics[CurveParams::Logic::Sprine13] = [this, calcSp1](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].sprine13;
+	}
+	float logicSprine13(const BaseCurveParams& prm, float x) {
+		auto& p = prm.sprine13;
 		float px1 = std::min(p.pos1.x, p.pos2.x);
 		float px2 = std::max(p.pos1.x, p.pos2.x);
 		float py1 = (p.pos1.x <= p.pos2.x) ? p.pos1.y : p.pos2.y;
@@ -410,10 +411,10 @@ CurveCore::CurveCore() {
 			float localCY = mapRange(p.cp3.y, py2, 1.0f, 0.0f, 1.0f);
 			return mapRange(calcSp1(mapRange(x, px2, 1.0f, 0.0f, 1.0f), localCX, localCY), 0.0f, 1.0f, py2, 1.0f);
 		}
-		};
+	}
 
-	logics[CurveParams::Logic::Sprine23] = [this, calcSp2](int pIdx, int tIdx, int prmIdx, float x) {
-		auto& p = m_params.params[pIdx][tIdx][prmIdx].sprine23;
+	float logicSprine23(const BaseCurveParams& prm, float x) {
+		auto& p = prm.sprine23;
 		float px1 = std::min(p.pos1.x, p.pos2.x);
 		float px2 = std::max(p.pos1.x, p.pos2.x);
 		float py1 = (p.pos1.x <= p.pos2.x) ? p.pos1.y : p.pos2.y;
@@ -440,25 +441,208 @@ CurveCore::CurveCore() {
 			float localCY2 = mapRange(p.cp6.y, py2, 1.0f, 0.0f, 1.0f);
 			return mapRange(calcSp2(mapRange(x, px2, 1.0f, 0.0f, 1.0f), localCX1, localCY1, localCX2, localCY2), 0.0f, 1.0f, py2, 1.0f);
 		}
-		};
+	}
+
+	// CurveParams::Logic の並び順どおりの関数表 (焼き込み時にスロットごとに一度だけ引く)
+	constexpr std::array<CurveLogicFunction, (size_t)CurveParams::Logic::Size> logicTable = {
+		logicLinear,
+		logicArcExp,
+		logicArcLog,
+		logicExp,
+		logicLog,
+		logicSp1,
+		logicSp2,
+		logicLinearArcExp,
+		logicLinearArcLog,
+		logicLinearExp,
+		logicLinearLog,
+		logicLinearSp1,
+		logicLinearSp2,
+		logicArcExpLinear,
+		logicArcLogLinear,
+		logicExpLinear,
+		logicLogLinear,
+		logicSp1Linear,
+		logicSp2Linear,
+		logicLinear2ArcExp,
+		logicLinear2ArcLog,
+		logicLinear2Exp,
+		logicLinear2Log,
+		logicLinear2Sp1,
+		logicLinear2Sp2,
+		logicLinear2,
+		logicLinear3,
+		logicSprine12,
+		logicSprine22,
+		logicSprine13,
+		logicSprine23,
+	};
 }
 
+CurveCore::CurveCore() : juce::Thread("CurveBaker") {
+	// 初期テーブル (以降の焼き直しはワーカースレッドで行う)
+	publishLut(bakeLut(m_params, std::bitset<CurveLut::slots>(), nullptr));
+
+	startThread();
+}
+
+CurveCore::~CurveCore()
+{
+	stopThread(2000);
+	releaseRetiredLuts(true);
+}
+
+// オーディオスレッドからも呼ばれるため、パラメータのコピーと要求フラグのみ行う
 void CurveCore::setParameters(const CurveParams& params)
 {
-	this->m_params = params;
+	{
+		const juce::SpinLock::ScopedLockType lock(m_paramLock);
+		if (std::memcmp(&this->m_params, &params, sizeof(CurveParams)) == 0) return;
+
+		this->m_params = params;
+	}
+
+	m_bakeRequested.store(true, std::memory_order_release);
 }
 
-float CurveCore::processRaw(int positionIndex, int targetIndex, int paramIndex, float x) const
+void CurveCore::bakeCurves()
 {
-	if (x <= 1e-5f) return 0.0f;
-	if (x >= 1.0f - 1e-5f) return 1.0f;
+	{
+		const juce::SpinLock::ScopedLockType lock(m_paramLock);
+		m_forcedSlots.set();
+	}
 
-	int logicIndex = m_params.params[positionIndex][targetIndex][paramIndex].logic;
-	auto logic = static_cast<CurveParams::Logic>(logicIndex);
+	m_bakeRequested.store(true, std::memory_order_release);
+	notify();
+}
 
-	// logics マップからの検索を安全に行う
-	auto it = logics.find(logic);
-	if (it == logics.end()) return x; // 見つからなければ線形
+void CurveCore::bakeCurvesPrim(int positionIndex, int targetIndex, int paramIndex)
+{
+	if (positionIndex < 0 || positionIndex >= CurveLut::positions) return;
+	if (targetIndex < 0 || targetIndex >= CurveLut::targets) return;
+	if (paramIndex < 0 || paramIndex >= CurveLut::params) return;
+
+	{
+		const juce::SpinLock::ScopedLockType lock(m_paramLock);
+		m_forcedSlots.set((size_t)CurveLut::slotIndex(positionIndex, targetIndex, paramIndex));
+	}
+
+	m_bakeRequested.store(true, std::memory_order_release);
+	notify();
+}
+
+bool CurveCore::isBaked() const
+{
+	if (m_bakeRequested.load(std::memory_order_acquire)) return false;
+
+	const CurveLut* lut = m_activeLut.load(std::memory_order_acquire);
+	if (lut == nullptr) return false;
+
+	const juce::SpinLock::ScopedLockType lock(m_paramLock);
+	return std::memcmp(&lut->bakedParams, &m_params, sizeof(CurveParams)) == 0;
+}
+
+void CurveCore::run()
+{
+	while (!threadShouldExit()) {
+		wait(pollIntervalMs);
+
+		if (m_bakeRequested.exchange(false, std::memory_order_acq_rel)) {
+			// 要求時点のパラメータを取り出し、ロックの外で焼き込む
+			auto params = std::make_unique<CurveParams>();
+			std::bitset<CurveLut::slots> forced;
+			{
+				const juce::SpinLock::ScopedLockType lock(m_paramLock);
+				*params = m_params;
+				forced = m_forcedSlots;
+				m_forcedSlots.reset();
+			}
+
+			publishLut(bakeLut(*params, forced, m_ownedLut.get()));
+		}
+
+		releaseRetiredLuts(false);
+	}
+}
+
+// base と比べてパラメータが変わったスロット (と forced のスロット) だけを計算し直す
+std::unique_ptr<CurveLut> CurveCore::bakeLut(const CurveParams& params, const std::bitset<CurveLut::slots>& forced, const CurveLut* base) const
+{
+	auto lut = std::make_unique<CurveLut>();
+	lut->bakedParams = params;
+
+	for (int p = 0; p < CurveLut::positions; ++p) {
+		for (int t = 0; t < CurveLut::targets; ++t) {
+			for (int prm = 0; prm < CurveLut::params; ++prm) {
+				int slot = CurveLut::slotIndex(p, t, prm);
+
+				bool dirty = base == nullptr || forced.test((size_t)slot)
+					|| std::memcmp(&base->bakedParams.params[p][t][prm], &params.params[p][t][prm], sizeof(BaseCurveParams)) != 0;
+
+				if (dirty) bakeSlot(*lut, p, t, prm);
+				else {
+					lut->tables[slot] = base->tables[slot];
+					lut->linear[slot] = base->linear[slot];
+				}
+			}
+		}
+	}
+
+	return lut;
+}
+
+void CurveCore::bakeSlot(CurveLut& lut, int positionIndex, int targetIndex, int paramIndex) const
+{
+	int slot = CurveLut::slotIndex(positionIndex, targetIndex, paramIndex);
+	auto& table = lut.tables[slot];
+	const auto& prm = lut.bakedParams.params[positionIndex][targetIndex][paramIndex];
+
+	// ロジックの解決はスロットごとに一度だけ行い、以降は関数ポインタを直接呼ぶ
+	CurveLogicFunction logic = resolveLogic(prm.logic);
+	lut.linear[slot] = logic == logicLinear;
+
+	for (int i = 0; i <= CurveLut::lutSize; ++i) {
+		float x = (float)i / (float)CurveLut::lutSize;
+		float result = processRaw(logic, prm, x);
+
+		if (std::isnan(result) || std::isinf(result)) result = x; // フェイルセーフ
+
+		table[i] = std::clamp(result, 0.0f, 1.0f);
+	}
+}
+
+void CurveCore::publishLut(std::unique_ptr<CurveLut> lut)
+{
+	m_activeLut.store(lut.get(), std::memory_order_release);
+
+	// オーディオスレッドがまだ旧テーブルを読んでいる可能性があるので、すぐには解放しない
+	if (m_ownedLut != nullptr) {
+		m_retiredLuts.push_back({ std::move(m_ownedLut), juce::Time::getMillisecondCounter() });
+	}
+
+	m_ownedLut = std::move(lut);
+}
+
+void CurveCore::releaseRetiredLuts(bool force)
+{
+	auto now = juce::Time::getMillisecondCounter();
+
+	m_retiredLuts.erase(std::remove_if(m_retiredLuts.begin(), m_retiredLuts.end(), [force, now](const RetiredLut& r) {
+		return force || now - r.retiredAt >= retireDelayMs;
+		}), m_retiredLuts.end());
+}
+
+CurveLogicFunction CurveCore::resolveLogic(int logicIndex) noexcept
+{
+	if (logicIndex < 0 || logicIndex >= (int)logicTable.size()) return logicLinear; // 範囲外は線形
+
+	return logicTable[(size_t)logicIndex];
+}
+
+float CurveCore::processRaw(CurveLogicFunction logic, const BaseCurveParams& prm, float x)
+{
+	if (x <= 1e-5f) return 0.0f;
+	if (x >= 1.0f - 1e-5f) return 1.0f;
 
-	return it->second(positionIndex, targetIndex, paramIndex, x);
+	return logic(prm, x);
 }
@@ -2,33 +2,91 @@
 
 #include <JuceHeader.h>
 
+#include <atomic>
+#include <bitset>
+#include <memory>
+#include <vector>
+
 #include "./AdvancedCurveParams.h"
 #include "../../Processor/Curve/ProcessorCurveValues.h"
 
-class CurveCore
+// カーブロジック 1 種類分の計算関数 (prm: 対象スロットのパラメータ, x: 正規化入力値)
+using CurveLogicFunction = float (*)(const BaseCurveParams& prm, float x);
+
+// カーブの焼き込み済みテーブル (Position x Target x Param ごとに lutSize + 1 点)
+struct CurveLut
+{
+    static constexpr int lutSize = 256;
+    static constexpr int positions = (int)CurveParams::Position::Size;
+    static constexpr int targets = (int)CurveParams::Target::Size;
+    static constexpr int params = 16;
+    static constexpr int slots = positions * targets * params;
+
+    using Table = std::array<float, lutSize + 1>;
+
+    std::array<Table, slots> tables;
+    std::array<bool, slots> linear{}; // 線形ロジックのスロット (テーブルを引かずに入力をそのまま返す)
+    CurveParams bakedParams; // このテーブルを焼いた時のパラメータ (差分検出用)
+
+    static constexpr int slotIndex(int positionIndex, int targetIndex, int paramIndex) noexcept {
+        return (positionIndex * targets + targetIndex) * params + paramIndex;
+    }
+};
+
+class CurveCore : private juce::Thread
 {
 private:
+    // オーディオスレッドが参照するテーブル (ワーカースレッドが差し替える)
+    std::atomic<const CurveLut*> m_activeLut{ nullptr };
+
+    // 以下はワーカースレッドのみが触る
+    std::unique_ptr<CurveLut> m_ownedLut;
+    struct RetiredLut { std::unique_ptr<CurveLut> lut; juce::uint32 retiredAt = 0; };
+    std::vector<RetiredLut> m_retiredLuts;
+
+    // 焼き込み要求 (m_paramLock で保護)
+    mutable juce::SpinLock m_paramLock;
     CurveParams m_params;
+    std::bitset<CurveLut::slots> m_forcedSlots;
+    std::atomic<bool> m_bakeRequested{ false };
+
+    static constexpr int pollIntervalMs = 20;      // 焼き込み要求の確認間隔
+    static constexpr juce::uint32 retireDelayMs = 1000; // 差し替え後、旧テーブルを解放するまでの猶予
 
-    std::map<CurveParams::Logic, std::function<float(int, int, int, float)>> logics; // ロジックごとの関数マップ
+    void run() override;
+    std::unique_ptr<CurveLut> bakeLut(const CurveParams& params, const std::bitset<CurveLut::slots>& forced, const CurveLut* base) const;
+    void bakeSlot(CurveLut& lut, int positionIndex, int targetIndex, int paramIndex) const;
+    void publishLut(std::unique_ptr<CurveLut> lut);
+    void releaseRetiredLuts(bool force);
+    static CurveLogicFunction resolveLogic(int logicIndex) noexcept;
+    static float processRaw(CurveLogicFunction logic, const BaseCurveParams& prm, float x);
 public:
     CurveCore();
+    ~CurveCore() override;
 
     int index = 0; // ロジック切り替えのインデックス
 
     void setParameters(const CurveParams& params);
-    void bakeCurves() {}
-    void bakeCurvesPrim(int positionIndex, int targetIndex, int paramIndex) {}
-    float processRaw(int positionIndex, int targetIndex, int paramIndex, float x) const;
+    void bakeCurves();
+    void bakeCurvesPrim(int positionIndex, int targetIndex, int paramIndex);
+    // 最新のパラメータが焼き込み済みテーブルに反映されているか (オフラインレンダリングの待ち合わせ用)
+    bool isBaked() const;
     inline float process(int positionIndex, int targetIndex, int paramIndex, float x) const noexcept { // x: 正規化入力値(0.0f ~ 1.0f)
+        if (std::isnan(x)) return 0.0f;
         float safeX = std::clamp(x, 0.0f, 1.0f);
-        if (std::isnan(safeX)) return 0.0f;
 
-        // LUT配列を参照せず、直接計算する（最新のCPUではこの方が安全で速い）
-        float result = processRaw(positionIndex, targetIndex, paramIndex, safeX);
+        // 焼き込み済みテーブルを線形補間で引く (NaN/範囲外は焼き込み時に処理済み)
+        const CurveLut* lut = m_activeLut.load(std::memory_order_acquire);
+        const int slot = CurveLut::slotIndex(positionIndex, targetIndex, paramIndex);
+        if (lut->linear[slot]) return safeX;
+
+        const auto& table = lut->tables[slot];
 
-        if (std::isnan(result) || std::isinf(result)) return safeX; // フェイルセーフ
+        float pos = safeX * (float)CurveLut::lutSize;
+        int i = (int)pos;
+        if (i >= CurveLut::lutSize) return table[CurveLut::lutSize];
 
-        return std::clamp(result, 0.0f, 1.0f);
+        float frac = pos - (float)i;
+        return table[i] + (table[i + 1] - table[i]) * frac;
     };
 };
@@ -7,10 +7,34 @@
 namespace Global
 {
 	static inline const int unisonVoices = 8; // ユニゾン発音数
-	static inline const int voices = 10; // 最大同時発音数
-	static inline const int totalVoices = voices * unisonVoices; // 最大同時発音数 * ユニゾン発音数
+	static inline const int voices = 10; // 最大同時発音数 (初期値)
+	static inline const int totalVoices = voices * unisonVoices; // 最大同時発音数 * ユニゾン発音数 (初期値)
 	static inline constexpr int floatDecimalPlaces = 6; // パラメータ書き出し時の小数点以下の桁数
 
+	// 設定画面で変更できる同時発音数の範囲
+	namespace Polyphony
+	{
+		static inline constexpr int min = 1;
+		static inline constexpr int max = 32;
+	};
+
+	// 設定画面で変更できるボイス描画の作業スレッド数 (0 はオーディオスレッドのみ)
+	namespace RenderThreads
+	{
+		static inline constexpr int min = 0;
+		static inline constexpr int max = 7;
+		static inline constexpr int initial = 0;
+	};
+
+	// 仮想サンプリングレートからホストのレートへの変換品質 (0:リニア 1:標準 2:高品質、VirtualRateResampler::Quality と同じ並び)
+	namespace ResampleQuality
+	{
+		static inline constexpr int min = 0;
+		static inline constexpr int max = 2;
+		static inline constexpr int initial = 1; // 新しく作ったインスタンスの値
+		static inline constexpr int legacy = 0;  // この設定が無いプロジェクト (導入前に保存) を読んだ時の値 (音と遅延を変えない)
+	};
+
 	namespace Plugin
 	{
 		static inline const juce::String name = ProjectInfo::projectName;
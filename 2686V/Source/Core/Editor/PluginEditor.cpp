@@ -103,6 +103,8 @@ AudioPlugin2686VEditor::AudioPlugin2686VEditor(AudioPlugin2686V& p)
     // 2. 保存された設定に基づいてON/OFF初期化
     setTooltipState(audioProcessor.showTooltips);
 
+    presetIndex.addChangeListener(this);
+
     if (presetGui->currentFolder.isDirectory()) {
         scanPresets();
     }
@@ -307,6 +309,7 @@ AudioPlugin2686VEditor::~AudioPlugin2686VEditor()
 {
     tabs.setLookAndFeel(nullptr);
     tabs.getTabbedButtonBar().removeChangeListener(this);
+    presetIndex.removeChangeListener(this);
 
     wtGui->removeComponentListener(this);
     wt2Gui->removeComponentListener(this);
@@ -359,6 +362,15 @@ void AudioPlugin2686VEditor::showMinimumView() {
 
 void AudioPlugin2686VEditor::changeListenerCallback(juce::ChangeBroadcaster* source)
 {
+    // プリセット一覧の走査が進んだ
+    if (source == &presetIndex)
+    {
+        presetGui->items = presetIndex.getItems(presetGui->currentFolder);
+        presetGui->updateTableContent();
+        presetGui->repaintTable();
+        return;
+    }
+
     if (source == &tabs.getTabbedButtonBar())
     {
         // 0:OPNA, 1:OPN, 2:OPL, ...
@@ -879,40 +891,15 @@ void AudioPlugin2686VEditor::scanPresets()
 {
     presetGui->clearTable();
 
-    // XMLファイルを探す
-    auto files = presetGui->currentFolder.findChildFiles(juce::File::findFiles, true, PresetValue::File::glob);
-
-    for (const auto& file : files)
-    {
-        PresetItem item;
-        item.file = file;
-        item.fileName = file.getFileName();
-        item.fullPath = file.getFullPathName();
-        item.lastModificationTime = file.getLastModificationTime();
-
-        // XMLをパースしてメタデータを取得
-        juce::XmlDocument xmlDoc(file);
-        auto xml = xmlDoc.getDocumentElement();
-        if (xml != nullptr)
-        {
-            item.name = xml->getStringAttribute(PresetKey::name, audioProcessor.presetName);
-            item.author = xml->getStringAttribute(PresetKey::author, audioProcessor.presetAuthor);
-            item.version = xml->getStringAttribute(PresetKey::version, audioProcessor.presetVersion);
-            item.comment = xml->getStringAttribute(PresetKey::comment, audioProcessor.presetComment);
-            item.modeName = xml->getStringAttribute(PresetKey::mode, PresetValue::MetaData::Initial::mode);
-            item.genre = xml->getStringAttribute(PresetKey::genre, PresetValue::MetaData::Initial::genre);
-        }
-        else
-        {
-            item.name = PresetValue::File::Message::invalidXmlNotice;
-        }
-
-        presetGui->items.push_back(item);
-    }
+    // まずはキャッシュにある分をすぐに表示する
+    presetGui->items = presetIndex.getItems(presetGui->currentFolder);
 
     // リスト更新
     presetGui->updateTableContent();
     presetGui->repaintTable();
+
+    // 追加・変更されたファイルはバックグラウンドで読み、読めた分から反映する (changeListenerCallback)
+    presetIndex.scan(presetGui->currentFolder);
 }
 
 void AudioPlugin2686VEditor::saveCurrentPreset()
@@ -1283,8 +1270,9 @@ void AudioPlugin2686VEditor::timerCallback()
 {
     if (isPreviewVisible || viewMode == ViewMode::MiniPlayer)
     {
-        std::vector<float> staticData;
-        audioProcessor.generatePreviewWaveform(&staticData);
+        // 静的プレビューは専用スレッドで描画し、出来上がった物だけを受け取る
+        audioProcessor.requestPreviewWaveform();
+        audioProcessor.getPreviewWaveform(previewWaveformData, previewWaveformVersion);
 
         // メモリ再確保を防ぐため static を付ける、もしくは std::array を使う
         static std::array<float, AudioPlugin2686V::previewBufferSize> localL;
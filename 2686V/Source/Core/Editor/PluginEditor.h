@@ -23,6 +23,7 @@
 #include "../../Gui/Adpcm/GuiAdpcm.h"
 #include "../../Gui/Beep/GuiBeep.h"
 #include "../../Gui/Preset/GuiPreset.h"
+#include "../../Gui/Preset/PresetIndex.h"
 #include "../../Gui/Fx/GuiFx.h"
 #include "../../Gui/Settings/GuiSettings.h"
 #include "../../Gui/About/GuiAbout.h"
@@ -203,6 +204,7 @@ private:
     std::unique_ptr<GuiAdpcm> adpcmGui; // ADPCM
     std::unique_ptr<GuiBeep> beepGui;
     std::unique_ptr<GuiPreset> presetGui;
+    PresetIndex presetIndex; // プリセット一覧のメタデータのキャッシュ
     std::unique_ptr<GuiCurve> curveGui;
 
     // 仮想MIDIキーボード用
@@ -223,6 +225,8 @@ private:
     GuiStateView playingState{ juce::Colours::yellow, juce::Colours::yellow.darker(0.9f).withAlpha(0.6f) };
 
     bool isPreviewVisible = false;
+    std::vector<float> previewWaveformData; // 最後に受け取ったプレビュー波形 (エディタごとに持つ)
+    int previewWaveformVersion = 0; // 最後に受け取ったプレビュー波形のバージョン
 
     enum class ViewMode { Full = 0, MiniPlayer = 1, Minimum = 2 };
     ViewMode viewMode = ViewMode::Full;
@@ -6,6 +6,7 @@
 #include "../../Gui/Settings/SettingsValues.h"
 
 #include "../Gui/GuiValues.h"
+#include "../Synth/SynthHelpers.h"
 
 // ============================================================================
 // Constructor
@@ -55,12 +56,9 @@ AudioPlugin2686V::AudioPlugin2686V()
     prCurve.init(apvts);
 
     m_synth.addSound(new SynthSound());
+    m_synth.activeVoices.reserve(Global::totalVoices);
     for (int i = 0; i < Global::totalVoices; i++) {
-        auto voice = new SynthVoice();
-
-        voice->prepare(44100.0);
-        voice->setCurveCore(&m_curveCore);
-        m_synth.addVoice(voice);
+        m_synth.addVoice(createVoice());
     }
 
     prFx.prepare(44100.0);
@@ -79,13 +77,22 @@ AudioPlugin2686V::AudioPlugin2686V()
     previewFx.prepare(44100.0);
 
     formatManager.registerBasicFormats();
+
+    // 品質設定の変更で必要になったエンコードはプールのスレッドで作る
+    pcmPool.setIdleCallback([this] { encodePendingPcmSamples(); });
+
     loadStartupSettings();
+
+    m_previewThread.startThread();
 }
 
 // ============================================================================
 // Destructor
 // ============================================================================
-AudioPlugin2686V::~AudioPlugin2686V() {}
+AudioPlugin2686V::~AudioPlugin2686V()
+{
+    m_previewThread.stopThread(2000);
+}
 
 // ============================================================================
 // Parameter Layout Definition (Visible to DAW and GUI)
@@ -154,6 +161,17 @@ void AudioPlugin2686V::prepareToPlay(double sampleRate, int samplesPerBlock)
         }
     }
 
+    // 作業スレッドのスクラッチはブロック長で確保する
+    m_maxBlockSize = samplesPerBlock;
+    m_synth.renderPool.prepare(m_renderThreads, samplesPerBlock, sampleRate);
+
+    prFx.prepare(sampleRate);
+    m_silentSamples = 0;
+    m_fxSuspended = false;
+
+    // プレビューは専用スレッドで描画しているので、描画の合間に作り直す
+    const juce::ScopedLock previewLock(m_previewRenderLock);
+
     previewSynth.setCurrentPlaybackSampleRate(sampleRate);
 
     for (int i = 0; i < previewSynth.getNumVoices(); ++i) {
@@ -162,8 +180,8 @@ void AudioPlugin2686V::prepareToPlay(double sampleRate, int samplesPerBlock)
         }
     }
 
-    prFx.prepare(sampleRate);
     previewFx.prepare(sampleRate);
+    m_previewHash = 0;
 }
 
 // ============================================================================
@@ -173,6 +191,10 @@ void AudioPlugin2686V::releaseResources()
 {
     // Memory release is handled automatically by JUCE Synthesiser class,
     // so this can basically be empty.
+
+    // 再生していない間は作業スレッドを止めておく (prepareToPlay で作り直す)
+    m_synth.renderPool.release();
+    m_maxBlockSize = 0;
 }
 
 // ============================================================================
@@ -188,6 +210,9 @@ void AudioPlugin2686V::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
 
     m_synth.currentParams = &m_currentParams;
 
+    // 読み込みが終わったサンプルをボイスに反映する
+    applyPcmSamples();
+
     // 【シンセモード】
     // 入力バッファはノイズの原因になるのでクリアする
     buffer.clear();
@@ -200,19 +225,7 @@ void AudioPlugin2686V::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
 
     if (m_currentParams.mode == OscMode::OPZX7)
     {
-        // プラグインプロセッサから直接最新のマトリックス情報を引っ張ってくる
-        m_currentParams.opzx7.algFb.matrix.mode = getOpzx7AlgMode();
-
-        // DSP用に定義した AlgMatrixParams へ移し替える
-        AlgMatrixState guiState = getOpzx7AlgMatrix();
-        for (int i = 0; i < 8; ++i) {
-            m_currentParams.opzx7.algFb.matrix.isCarrier[i] = guiState.isCarrier[i];
-            for (int j = 0; j < 8; ++j) {
-                // UIで設定した値をそのままDSPの配列にマッピングする
-                m_currentParams.opzx7.algFb.matrix.mod[i][j] = guiState.mod[i][j];
-                m_currentParams.opzx7.algFb.matrix.fbMod[i][j] = guiState.fbMod[i][j];
-            }
-        }
+        applyOpzx7AlgMatrix(m_currentParams);
     }
 
 	// エンベロープカーブの処理は、シンセモードに関わらず常に行う
@@ -238,27 +251,69 @@ void AudioPlugin2686V::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
     m_synth.fixedVelocity = fixedVelocity;
     m_currentParams.fixedVelocity = fixedVelocity;
 
+    m_currentParams.resampleQuality = m_resampleQuality.load(std::memory_order_relaxed);
+    m_currentParams.oscAntialias = m_oscAntialias.load(std::memory_order_relaxed);
+
     // Apply to each voice
-    for (int i = 0; i < m_synth.getNumVoices(); ++i)
+    // 変化があった時だけバージョンを進め、発音中のボイスのアクティブなコアにのみ反映する
+    // (停止中のボイスは startNote 時に syncParameters で追従する)
+    if (updateParamSnapshot()) {
+        ++m_paramVersion;
+    }
+
+    bool anyVoiceActive = false;
+
+    for (auto* voice : m_synth.activeVoices)
     {
-        if (auto* voice = static_cast<SynthVoice*>(m_synth.getVoice(i)))
-        {
-            voice->setParameters(m_currentParams);
+        if (voice->isVoiceActive()) {
+            voice->syncParameters();
+            anyVoiceActive = true;
         }
     }
 
-    m_curveCore.setParameters(m_currentParams.curve);
+    if (PrHelper::updateSnapshot(m_currentParams.curve, m_pushedParams.curve)) {
+        m_curveCore.setParameters(m_currentParams.curve);
+        ++m_previewContentVersion;
+    }
 
-    // シンセの発音
-    m_synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+    const int numBlockSamples = buffer.getNumSamples();
 
-    // ヘッドルーム適応
-    if (useHeadroom)
-    {
-        buffer.applyGain(headroomGain);
+    // 発音中のボイスも MIDI も無ければ、シンセの出力は無音 (buffer はクリア済み)
+    const bool synthIdle = !anyVoiceActive && midiMessages.isEmpty();
+
+    if (synthIdle) {
+        m_silentSamples += numBlockSamples;
+    }
+    else {
+        m_silentSamples = 0;
+
+        // シンセの発音
+        m_synth.renderNextBlock(buffer, midiMessages, 0, numBlockSamples);
+
+        // ヘッドルーム適応
+        if (useHeadroom)
+        {
+            buffer.applyGain(headroomGain);
+        }
     }
 
-	prFx.processBlock(buffer, m_currentParams, apvts);
+    // 入力の無音がこのブロックより前に FX のテール分続いていれば、FX も鳴らし切っているので処理しない
+    // (止める時に内部バッファを消しておき、再開時に -90dB 未満の残りかすが出ないようにする)
+    // 止めている間もパラメータとバイパスだけは反映して、ホストへ報告するテールの長さを最新に保つ
+    if (m_fxSuspended) prFx.updateParameters();
+
+    const double tailSamples = prFx.getTailSeconds() * getSampleRate();
+
+    if (synthIdle && (double)(m_silentSamples - numBlockSamples) >= tailSamples) {
+        if (!m_fxSuspended) {
+            prFx.clear();
+            m_fxSuspended = true;
+        }
+    }
+    else {
+        m_fxSuspended = false;
+        prFx.processBlock(buffer, m_currentParams, apvts);
+    }
 
     if (previewVisiblity)
     {
@@ -289,6 +344,54 @@ void AudioPlugin2686V::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
     }
 }
 
+// ============================================================================
+// Parameter Snapshot
+// ============================================================================
+bool AudioPlugin2686V::updateParamSnapshot()
+{
+    bool changed = false;
+
+    if (m_pushedParams.mode != m_currentParams.mode) {
+        m_pushedParams.mode = m_currentParams.mode;
+        changed = true;
+    }
+
+    if (m_pushedParams.monoMode != m_currentParams.monoMode ||
+        m_pushedParams.useVelocity != m_currentParams.useVelocity ||
+        m_pushedParams.pitchResetOnLegato != m_currentParams.pitchResetOnLegato ||
+        m_pushedParams.fixedVelocity != m_currentParams.fixedVelocity ||
+        m_pushedParams.resampleQuality != m_currentParams.resampleQuality ||
+        m_pushedParams.oscAntialias != m_currentParams.oscAntialias)
+    {
+        m_pushedParams.monoMode = m_currentParams.monoMode;
+        m_pushedParams.useVelocity = m_currentParams.useVelocity;
+        m_pushedParams.pitchResetOnLegato = m_currentParams.pitchResetOnLegato;
+        m_pushedParams.fixedVelocity = m_currentParams.fixedVelocity;
+        m_pushedParams.resampleQuality = m_currentParams.resampleQuality;
+        m_pushedParams.oscAntialias = m_currentParams.oscAntialias;
+        changed = true;
+    }
+
+    // 現在のモードのセクションだけを比較する (他モードのセクションはボイスに送られない)
+    switch (m_currentParams.mode) {
+    case OscMode::OPNA:      changed |= PrHelper::updateSnapshot(m_currentParams.opna, m_pushedParams.opna); break;
+    case OscMode::OPN:       changed |= PrHelper::updateSnapshot(m_currentParams.opn, m_pushedParams.opn); break;
+    case OscMode::OPL:       changed |= PrHelper::updateSnapshot(m_currentParams.opl, m_pushedParams.opl); break;
+    case OscMode::OPL3:      changed |= PrHelper::updateSnapshot(m_currentParams.opl3, m_pushedParams.opl3); break;
+    case OscMode::OPM:       changed |= PrHelper::updateSnapshot(m_currentParams.opm, m_pushedParams.opm); break;
+    case OscMode::OPZX7:     changed |= PrHelper::updateSnapshot(m_currentParams.opzx7, m_pushedParams.opzx7); break;
+    case OscMode::SSG:       changed |= PrHelper::updateSnapshot(m_currentParams.ssg, m_pushedParams.ssg); break;
+    case OscMode::WAVETABLE: changed |= PrHelper::updateSnapshot(m_currentParams.wt, m_pushedParams.wt); break;
+    case OscMode::WT2:       changed |= PrHelper::updateSnapshot(m_currentParams.wt2, m_pushedParams.wt2); break;
+    case OscMode::RHYTHM:    changed |= PrHelper::updateSnapshot(m_currentParams.rhythm, m_pushedParams.rhythm); break;
+    case OscMode::ADPCM:     changed |= PrHelper::updateSnapshot(m_currentParams.adpcm, m_pushedParams.adpcm); break;
+    case OscMode::BEEP:      changed |= PrHelper::updateSnapshot(m_currentParams.beep, m_pushedParams.beep); break;
+    default: break;
+    }
+
+    return changed;
+}
+
 // ============================================================================
 // Editor (GUI) Related
 // ============================================================================
@@ -300,72 +403,127 @@ juce::AudioProcessorEditor* AudioPlugin2686V::createEditor()
 
 void AudioPlugin2686V::loadAdpcmFile(const juce::File& file)
 {
-    auto* reader = formatManager.createReaderFor(file);
-    if (reader != nullptr)
-    {
-        adpcmFilePath = file.getFullPathName();
+    if (!file.existsAsFile()) return;
 
-        std::unique_ptr<juce::AudioFormatReader> audioReader(reader);
+    adpcmFilePath = file.getFullPathName();
 
-        // Buffer to load the entire file
-        juce::AudioBuffer<float> fileBuffer;
-        fileBuffer.setSize(audioReader->numChannels, (int)audioReader->lengthInSamples);
+    // デコードとエンコードはプールのスレッドで行う (同じファイルはプールから再利用する)
+    auto quality = prAdpcm.getQuality();
+    requestPcmSample(adpcmPcmSlot, file, quality, getTargetRate(quality.rate, 16000.0f));
+}
 
-        // Execute load
-        audioReader->read(&fileBuffer, 0, (int)audioReader->lengthInSamples, 0, true, true);
+// Function to load Rhythm file
+void AudioPlugin2686V::loadRhythmFile(const juce::File& file, int padIndex)
+{
+    if (padIndex < 0 || padIndex >= RhythmPrValue::pads) return;
+    if (!file.existsAsFile()) return;
 
-        // Convert to mono std::vector<float>
-        std::vector<float> sourceData;
-        sourceData.resize(fileBuffer.getNumSamples());
+    rhythmFilePaths[padIndex] = file.getFullPathName();
 
-        // Get only L channel or mix LR
-        auto* channelData = fileBuffer.getReadPointer(0);
-        for (int i = 0; i < fileBuffer.getNumSamples(); ++i)
-        {
-            sourceData[i] = channelData[i];
-            // Add mixing logic here if stereo support is needed
+    auto quality = prRhythm.getQuality(padIndex);
+    requestPcmSample(padIndex, file, quality, getTargetRate(quality.rate));
+}
+
+void AudioPlugin2686V::requestPcmSample(int slotIndex, const juce::File& file, const QualityPcmParams& quality, double targetRate)
+{
+    int serial = ++m_pcmSlots[slotIndex].serial;
+
+    pcmPool.loadAsync(file, quality.mode, targetRate, [this, slotIndex, serial](PcmSample::Ptr sample) {
+        if (sample != nullptr) publishPcmSample(slotIndex, serial, sample);
+    });
+}
+
+// プールのスレッド (読み込み完了時) またはメッセージスレッド (解除時) から呼ばれる
+void AudioPlugin2686V::publishPcmSample(int slotIndex, int serial, PcmSample::Ptr sample)
+{
+    auto& slot = m_pcmSlots[slotIndex];
+
+    const juce::ScopedLock lock(m_pcmRetainLock);
+
+    // 後から別の要求 (読み込み・解除) が来ていれば、この結果は使わない
+    if (slot.serial.load() != serial) return;
+
+    if (sample != nullptr) m_pcmRetained.addIfNotAlreadyThere(sample.get());
+    slot.published.store(sample.get());
+
+    releaseUnusedPcmSamples();
+}
+
+// オーディオスレッドから呼ばれる (ロックしない)
+void AudioPlugin2686V::applyPcmSamples()
+{
+    for (int slotIndex = 0; slotIndex < (int)m_pcmSlots.size(); ++slotIndex)
+    {
+        auto& slot = m_pcmSlots[slotIndex];
+
+        PcmSample* sample = slot.published.load();
+        if (sample == slot.applied.load()) continue;
+
+        // 先に applied で参照を宣言し、その間に差し替えられていないか確認する
+        // (差し替えられていた場合、古い方は解放されている可能性があるので触らない)
+        slot.applied.store(sample);
+        while (slot.published.load() != sample) {
+            sample = slot.published.load();
+            slot.applied.store(sample);
         }
 
-        // --- Set data to AdpcmCore for all voices ---
-        // Important: Distribute data to all Voices
         for (int i = 0; i < m_synth.getNumVoices(); ++i)
         {
             if (auto* voice = static_cast<SynthVoice*>(m_synth.getVoice(i)))
             {
-                // Set while letting AdpcmCore handle "Resampling & 4bit degradation"
-                voice->getAdpcmCore()->setSampleData(sourceData, audioReader->sampleRate);
+                if (slotIndex == adpcmPcmSlot) {
+                    voice->getAdpcmCore()->setSampleData(sample);
+                }
+                else {
+                    voice->getRhythmCore()->setSampleData(slotIndex, sample);
+                }
             }
         }
     }
 }
 
-// Function to load Rhythm file
-void AudioPlugin2686V::loadRhythmFile(const juce::File& file, int padIndex)
+// プールのスレッドから定期的に呼ばれる
+// 現在の品質設定のエンコード結果が無ければ作り、各ボイスは出来上がったものを拾う
+void AudioPlugin2686V::encodePendingPcmSamples()
 {
-    auto* reader = formatManager.createReaderFor(file);
-    if (reader != nullptr)
+    for (int slotIndex = 0; slotIndex < (int)m_pcmSlots.size(); ++slotIndex)
     {
-        if (padIndex >= 0 && padIndex < RhythmPrValue::pads) {
-            rhythmFilePaths[padIndex] = file.getFullPathName();
+        PcmSample::Ptr sample;
+        {
+            const juce::ScopedLock lock(m_pcmRetainLock);
+            sample = m_pcmSlots[slotIndex].published.load();
         }
 
-        std::unique_ptr<juce::AudioFormatReader> audioReader(reader);
-        juce::AudioBuffer<float> fileBuffer;
-        fileBuffer.setSize(audioReader->numChannels, (int)audioReader->lengthInSamples);
-        audioReader->read(&fileBuffer, 0, (int)audioReader->lengthInSamples, 0, true, true);
+        if (sample == nullptr) continue;
 
-        std::vector<float> sourceData(fileBuffer.getNumSamples());
-        auto* channelData = fileBuffer.getReadPointer(0);
-        for (int i = 0; i < fileBuffer.getNumSamples(); ++i) {
-            sourceData[i] = channelData[i];
+        if (slotIndex == adpcmPcmSlot) {
+            auto quality = prAdpcm.getQuality();
+            GenPcmPool::prepareEncoded(*sample, quality.mode, getTargetRate(quality.rate, 16000.0f));
         }
+        else {
+            auto quality = prRhythm.getQuality(slotIndex);
+            GenPcmPool::prepareEncoded(*sample, quality.mode, getTargetRate(quality.rate));
+        }
+    }
+}
 
-        // Set data to the specified pad of RhythmCore for all voices
-        for (int i = 0; i < m_synth.getNumVoices(); ++i) {
-            if (auto* voice = static_cast<SynthVoice*>(m_synth.getVoice(i))) {
-                voice->getRhythmCore()->setSampleData(padIndex, sourceData, reader->sampleRate);
+// m_pcmRetainLock を取った状態で呼ぶ
+void AudioPlugin2686V::releaseUnusedPcmSamples()
+{
+    for (int i = m_pcmRetained.size(); --i >= 0;)
+    {
+        auto* sample = m_pcmRetained.getObjectPointerUnchecked(i);
+        bool inUse = false;
+
+        for (auto& slot : m_pcmSlots)
+        {
+            if (slot.published.load() == sample || slot.applied.load() == sample) {
+                inUse = true;
+                break;
             }
         }
+
+        if (!inUse) m_pcmRetained.remove(i);
     }
 }
 
@@ -376,7 +534,7 @@ const juce::String AudioPlugin2686V::getName() const { return Global::Plugin::na
 bool AudioPlugin2686V::acceptsMidi() const { return true; }
 bool AudioPlugin2686V::producesMidi() const { return false; }
 bool AudioPlugin2686V::isMidiEffect() const { return false; }
-double AudioPlugin2686V::getTailLengthSeconds() const { return 0.0; }
+double AudioPlugin2686V::getTailLengthSeconds() const { return prFx.getTailSeconds(); }
 int AudioPlugin2686V::getNumPrograms() { return 1; }
 int AudioPlugin2686V::getCurrentProgram() { return 0; }
 void AudioPlugin2686V::setCurrentProgram(int index) {}
@@ -517,6 +675,13 @@ void AudioPlugin2686V::getStateInformation(juce::MemoryBlock& destData) {
 
     setPresetToXml(xml);
 
+    // 同時発音数はプリセットではなくプロジェクトに保存する
+    xml->setAttribute(SettingsKey::polyphony, m_polyphony);
+    xml->setAttribute(SettingsKey::unisonLimit, m_unisonLimit);
+    xml->setAttribute(SettingsKey::renderThreads, m_renderThreads);
+    xml->setAttribute(SettingsKey::resampleQuality, getResampleQuality());
+    xml->setAttribute(SettingsKey::oscAntialias, getOscAntialias());
+
     copyXmlToBinary(*xml, destData);
 }
 
@@ -564,6 +729,15 @@ void AudioPlugin2686V::setStateInformation(const void* data, int sizeInBytes) {
         // {
         getPresetFromXml(xmlState);
         // }
+
+        setVoiceLimits(
+            xmlState->getIntAttribute(SettingsKey::polyphony, Global::voices),
+            xmlState->getIntAttribute(SettingsKey::unisonLimit, Global::unisonVoices)
+        );
+
+        setRenderThreads(xmlState->getIntAttribute(SettingsKey::renderThreads, Global::RenderThreads::initial));
+        setResampleQuality(xmlState->getIntAttribute(SettingsKey::resampleQuality, Global::ResampleQuality::legacy));
+        setOscAntialias(xmlState->getBoolAttribute(SettingsKey::oscAntialias, false));
     }
     else
     {
@@ -903,39 +1077,20 @@ void AudioPlugin2686V::unloadAdpcmFile()
     // パス情報を削除
     adpcmFilePath.clear();
 
-    // 空のデータを作成
-    std::vector<float> emptyData(1, 0.0f);
-
-    // 全ボイスの ADPCM Core に空データをセット（＝クリア）
-    for (int i = 0; i < m_synth.getNumVoices(); ++i)
-    {
-        if (auto* voice = static_cast<SynthVoice*>(m_synth.getVoice(i)))
-        {
-            // レートはなんでも良いので適当な値(44100)を渡す
-            voice->getAdpcmCore()->clearBuffer();
-        }
-    }
+    // 読み込み中の要求も含めて取り消し、次のブロックで全ボイスのサンプル参照をクリアする
+    publishPcmSample(adpcmPcmSlot, ++m_pcmSlots[adpcmPcmSlot].serial, nullptr);
 }
 
 void AudioPlugin2686V::unloadRhythmFile(int padIndex)
 {
     // インデックスチェック
-    if (padIndex < 0 || padIndex >= 8) return;
+    if (padIndex < 0 || padIndex >= RhythmPrValue::pads) return;
 
     // パス情報を削除
     rhythmFilePaths[padIndex].clear();
 
-    // 空のデータを作成
-    std::vector<float> emptyData(1, 0.0f);
-
-    // 全ボイスの Rhythm Core の該当パッドに空データをセット
-    for (int i = 0; i < m_synth.getNumVoices(); ++i)
-    {
-        if (auto* voice = static_cast<SynthVoice*>(m_synth.getVoice(i)))
-        {
-            voice->getRhythmCore()->clearBuffer(padIndex);
-        }
-    }
+    // 全ボイスの Rhythm Core の該当パッドのサンプル参照は次のブロックでクリアされる
+    publishPcmSample(padIndex, ++m_pcmSlots[padIndex].serial, nullptr);
 }
 
 // 絶対パスのFileを、defaultSampleDirからの相対パス文字列に変換する
@@ -1164,7 +1319,11 @@ void AudioPlugin2686V::loadOpzx7PcmFile(int opIndex, const juce::File& file)
         delete reader;
 
         auto* readPtr = tempBuffer.getReadPointer(0);
-        opzx7PcmBuffers[opIndex].assign(readPtr, readPtr + tempBuffer.getNumSamples());
+        {
+            const juce::ScopedLock previewLock(m_previewRenderLock);
+            opzx7PcmBuffers[opIndex].assign(readPtr, readPtr + tempBuffer.getNumSamples());
+            ++m_previewContentVersion;
+        }
         opzx7PcmFilePaths[opIndex] = file.getFullPathName();
 
         for (int i = 0; i < m_synth.getNumVoices(); ++i) {
@@ -1179,7 +1338,11 @@ void AudioPlugin2686V::unloadOpzx7PcmFile(int opIndex)
 {
     if (opIndex < 0 || opIndex >= Opzx7PrValue::ops) return;
 
-    opzx7PcmBuffers[opIndex].clear();
+    {
+        const juce::ScopedLock previewLock(m_previewRenderLock);
+        opzx7PcmBuffers[opIndex].clear();
+        ++m_previewContentVersion;
+    }
     opzx7PcmFilePaths[opIndex] = juce::String();
 
     for (int i = 0; i < m_synth.getNumVoices(); ++i) {
@@ -1189,9 +1352,91 @@ void AudioPlugin2686V::unloadOpzx7PcmFile(int opIndex)
     }
 }
 
-void AudioPlugin2686V::generatePreviewWaveform(std::vector<float>* destBuffer)
+void AudioPlugin2686V::requestPreviewWaveform()
+{
+    m_previewThread.notify();
+}
+
+bool AudioPlugin2686V::getPreviewWaveform(std::vector<float>& dest, int& lastVersion)
 {
-    // 1. パラメータの取得と設定
+    int version = m_previewVersion.load(std::memory_order_acquire);
+    if (version == lastVersion) return false;
+
+    const juce::SpinLock::ScopedLockType lock(m_previewPublishLock);
+    dest = m_previewWaveform;
+    lastVersion = version;
+
+    return true;
+}
+
+void AudioPlugin2686V::PreviewThread::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(-1);
+
+        if (threadShouldExit()) break;
+
+        owner.renderPreviewIfChanged();
+    }
+}
+
+// プレビュー描画スレッドから呼ばれる
+void AudioPlugin2686V::renderPreviewIfChanged()
+{
+    const juce::ScopedLock lock(m_previewRenderLock);
+
+    collectPreviewParams();
+
+    // 前回描画した時と同じ内容なら描画しない
+    auto hash = computePreviewHash();
+    if (hash == m_previewHash) return;
+
+    std::vector<float> waveform;
+    generatePreviewWaveform(&waveform);
+
+    {
+        const juce::SpinLock::ScopedLockType publishLock(m_previewPublishLock);
+        m_previewWaveform.swap(waveform);
+    }
+
+    m_previewHash = hash;
+    m_previewVersion.fetch_add(1, std::memory_order_release);
+}
+
+juce::uint64 AudioPlugin2686V::computePreviewHash()
+{
+    // 現在のモードのセクションだけを見る (他モードのセクションはプレビューに影響しない)
+    auto hash = PrHelper::hashStruct(m_previewParams.mode);
+
+    switch (m_previewParams.mode) {
+    case OscMode::OPNA:      hash = PrHelper::hashStruct(m_previewParams.opna, hash); break;
+    case OscMode::OPN:       hash = PrHelper::hashStruct(m_previewParams.opn, hash); break;
+    case OscMode::OPL:       hash = PrHelper::hashStruct(m_previewParams.opl, hash); break;
+    case OscMode::OPL3:      hash = PrHelper::hashStruct(m_previewParams.opl3, hash); break;
+    case OscMode::OPM:       hash = PrHelper::hashStruct(m_previewParams.opm, hash); break;
+    case OscMode::OPZX7:     hash = PrHelper::hashStruct(m_previewParams.opzx7, hash); break;
+    case OscMode::SSG:       hash = PrHelper::hashStruct(m_previewParams.ssg, hash); break;
+    case OscMode::WAVETABLE: hash = PrHelper::hashStruct(m_previewParams.wt, hash); break;
+    case OscMode::WT2:       hash = PrHelper::hashStruct(m_previewParams.wt2, hash); break;
+    case OscMode::RHYTHM:    hash = PrHelper::hashStruct(m_previewParams.rhythm, hash); break;
+    case OscMode::ADPCM:     hash = PrHelper::hashStruct(m_previewParams.adpcm, hash); break;
+    case OscMode::BEEP:      hash = PrHelper::hashStruct(m_previewParams.beep, hash); break;
+    default: break;
+    }
+
+    hash = previewFx.hashParameters(hash);
+
+    int contentVersion = m_previewContentVersion.load();
+    hash = PrHelper::hashStruct(contentVersion, hash);
+
+    // 0 は「未描画」として使うので避ける
+    return hash != 0 ? hash : 1;
+}
+
+void AudioPlugin2686V::collectPreviewParams()
+{
+    // パラメータの取得
     int m = PrHelper::getInt(pMode);
     m_previewParams.mode = (OscMode)m;
 
@@ -1209,7 +1454,11 @@ void AudioPlugin2686V::generatePreviewWaveform(std::vector<float>* destBuffer)
     case OscMode::ADPCM:     prAdpcm.processBlock(m_previewParams, apvts); break;
     case OscMode::BEEP:      prBeep.processBlock(m_previewParams, apvts); break;
     }
+}
 
+void AudioPlugin2686V::generatePreviewWaveform(std::vector<float>* destBuffer)
+{
+    // 1. パラメータの設定 (collectPreviewParams で取得済み)
     if (auto* voice = dynamic_cast<SynthVoice*>(previewSynth.getVoice(0))) {
         voice->setParameters(m_previewParams);
         for (int i = 0; i < Opzx7PrValue::ops; ++i) {
@@ -1287,6 +1536,93 @@ void AudioPlugin2686V::generatePreviewWaveform(std::vector<float>* destBuffer)
     }
 }
 
+SynthVoice* AudioPlugin2686V::createVoice()
+{
+    auto voice = new SynthVoice();
+
+    voice->prepare(getSampleRate() > 0.0 ? getSampleRate() : 44100.0);
+    voice->setCurveCore(&m_curveCore);
+    voice->setParameterSource(&m_currentParams, &m_paramVersion);
+    voice->setActiveList(&m_synth.activeVoices);
+
+    // 読み込み済みのサンプル・波形を引き継ぐ
+    for (int i = 0; i < Opzx7PrValue::ops; ++i) {
+        voice->setOpzx7PcmBuffer(i, &opzx7PcmBuffers[i]);
+        voice->setOpzx7WtBuffer(i, &opzx7WtBuffers[i]);
+        voice->setOpzx7Wt2Buffer(i, &opzx7Wt2Buffers[i]);
+    }
+
+    for (int slotIndex = 0; slotIndex < (int)m_pcmSlots.size(); ++slotIndex) {
+        PcmSample* sample = m_pcmSlots[slotIndex].applied.load();
+        if (sample == nullptr) continue;
+
+        if (slotIndex == adpcmPcmSlot) {
+            voice->getAdpcmCore()->setSampleData(sample);
+        }
+        else {
+            voice->getRhythmCore()->setSampleData(slotIndex, sample);
+        }
+    }
+
+    return voice;
+}
+
+void AudioPlugin2686V::setVoiceLimits(int polyphony, int unisonLimit)
+{
+    polyphony = std::clamp(polyphony, Global::Polyphony::min, Global::Polyphony::max);
+    unisonLimit = std::clamp(unisonLimit, 1, Global::unisonVoices);
+
+    if (polyphony == m_polyphony && unisonLimit == m_unisonLimit) return;
+
+    const int totalVoices = polyphony * unisonLimit;
+
+    // processBlock を抜けるまで待ってから止め、その間にボイスを作り直す
+    suspendProcessing(true);
+
+    for (auto* voice : m_synth.activeVoices) {
+        voice->stopNote(0.0f, false);
+    }
+    m_synth.activeVoices.clear();
+    m_synth.activeVoices.reserve(totalVoices);
+
+    while (m_synth.getNumVoices() > totalVoices) {
+        m_synth.removeVoice(m_synth.getNumVoices() - 1);
+    }
+
+    while (m_synth.getNumVoices() < totalVoices) {
+        m_synth.addVoice(createVoice());
+    }
+
+    m_synth.unisonLimit = unisonLimit;
+    m_polyphony = polyphony;
+    m_unisonLimit = unisonLimit;
+
+    suspendProcessing(false);
+}
+
+void AudioPlugin2686V::setRenderThreads(int numThreads)
+{
+    numThreads = std::clamp(numThreads, Global::RenderThreads::min, Global::RenderThreads::max);
+
+    if (numThreads == m_renderThreads) return;
+
+    // processBlock を抜けるまで待ってから止め、その間に作業スレッドを作り直す
+    suspendProcessing(true);
+
+    m_renderThreads = numThreads;
+    if (m_maxBlockSize > 0) {
+        m_synth.renderPool.prepare(m_renderThreads, m_maxBlockSize, getSampleRate());
+    }
+
+    suspendProcessing(false);
+}
+
+void AudioPlugin2686V::setResampleQuality(int quality)
+{
+    // 次の processBlock で SynthParams 経由で各コアへ届き、コアはブロック先頭で変換の設定を作り直す
+    m_resampleQuality.store(std::clamp(quality, Global::ResampleQuality::min, Global::ResampleQuality::max));
+}
+
 void AudioPlugin2686V::panic()
 {
     // 1. 全てのボイス（回路）の音を強制的に停止（切り離し）します
@@ -1322,7 +1658,11 @@ void AudioPlugin2686V::loadOpzx7WtFile(int opIndex, const juce::File& file)
         }
     }
 
-    opzx7WtBuffers[opIndex] = values;
+    {
+        const juce::ScopedLock previewLock(m_previewRenderLock);
+        opzx7WtBuffers[opIndex] = values;
+        ++m_previewContentVersion;
+    }
     opzx7WtFilePaths[opIndex] = file.getFullPathName();
 
     for (int i = 0; i < m_synth.getNumVoices(); ++i) {
@@ -1336,7 +1676,11 @@ void AudioPlugin2686V::unloadOpzx7WtFile(int opIndex)
 {
     if (opIndex < 0 || opIndex >= Opzx7PrValue::ops) return;
 
-    opzx7WtBuffers[opIndex].clear();
+    {
+        const juce::ScopedLock previewLock(m_previewRenderLock);
+        opzx7WtBuffers[opIndex].clear();
+        ++m_previewContentVersion;
+    }
     opzx7WtFilePaths[opIndex] = juce::String();
 
     for (int i = 0; i < m_synth.getNumVoices(); ++i) {
@@ -1376,7 +1720,11 @@ void AudioPlugin2686V::loadOpzx7Wt2File(int opIndex, const juce::File& file)
         }
     }
 
-    opzx7Wt2Buffers[opIndex] = values;
+    {
+        const juce::ScopedLock previewLock(m_previewRenderLock);
+        opzx7Wt2Buffers[opIndex] = values;
+        ++m_previewContentVersion;
+    }
     opzx7Wt2FilePaths[opIndex] = file.getFullPathName();
 
     for (int i = 0; i < m_synth.getNumVoices(); ++i) {
@@ -1390,7 +1738,11 @@ void AudioPlugin2686V::unloadOpzx7Wt2File(int opIndex)
 {
     if (opIndex < 0 || opIndex >= Opzx7PrValue::ops) return;
 
-    opzx7Wt2Buffers[opIndex].clear();
+    {
+        const juce::ScopedLock previewLock(m_previewRenderLock);
+        opzx7Wt2Buffers[opIndex].clear();
+        ++m_previewContentVersion;
+    }
     opzx7Wt2FilePaths[opIndex] = juce::String();
 
     for (int i = 0; i < m_synth.getNumVoices(); ++i) {
@@ -1433,15 +1785,8 @@ void AudioPlugin2686V::updateFxOrder(std::vector<int> newOrder)
 
 bool AudioPlugin2686V::isPlaying()
 {
-    bool flag = false;
-
-    for (int i = 0; i < m_synth.getNumVoices(); ++i) {
-        if (auto* voice = dynamic_cast<SynthVoice*>(m_synth.getVoice(i))) {
-            flag = flag || voice->isVoiceActive() || voice->isPlaying();
-        }
-    }
-
-    return flag;
+    // GUI スレッドから呼ばれるので、オーディオスレッドが更新する発音数だけを見る
+    return m_synth.activeVoices.getNumActive() > 0;
 }
 
 bool AudioPlugin2686V::isMidiProcessing() {
@@ -1474,9 +1819,10 @@ int AudioPlugin2686V::getOpzx7AlgMode() const
 void AudioPlugin2686V::setOpzx7AlgMatrix(const AlgMatrixState& state)
 {
     {
-        // DSPスレッドと競合しないようにロックしてキャッシュを更新
+        // 原本を更新し、オーディオスレッド向けのスナップショットとして公開する
         juce::ScopedLock lock(m_matrixLock);
         m_opzx7AlgMatrixState = state;
+        publishOpzx7AlgMatrix(m_opzx7AlgMatrixState);
     }
 
     // 状態を 1 と 0 の文字列にシリアライズしてAPVTSに保存
@@ -1511,6 +1857,93 @@ AlgMatrixState AudioPlugin2686V::getOpzx7AlgMatrix()
     return m_opzx7AlgMatrixState;
 }
 
+void AudioPlugin2686V::publishOpzx7AlgMatrix(const AlgMatrixState& state)
+{
+    // 呼び出し側で m_matrixLock を保持していること (書き手は常に 1 つ)
+    juce::uint32 carrier = 0;
+    juce::uint64 mod = 0;
+    juce::uint64 fbMod = 0;
+
+    for (int i = 0; i < 8; ++i) {
+        if (state.isCarrier[i]) carrier |= 1u << i;
+        for (int j = 0; j < 8; ++j) {
+            const int bit = i * 8 + j;
+            if (state.mod[i][j]) mod |= (juce::uint64)1 << bit;
+            if (state.fbMod[i][j]) fbMod |= (juce::uint64)1 << bit;
+        }
+    }
+
+    const juce::uint32 seq = m_algMatrixSeq.load(std::memory_order_relaxed);
+    m_algMatrixSeq.store(seq + 1, std::memory_order_relaxed); // 奇数: 書き込み中
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_algMatrixCarrierBits.store(carrier, std::memory_order_relaxed);
+    m_algMatrixModBits.store(mod, std::memory_order_relaxed);
+    m_algMatrixFbModBits.store(fbMod, std::memory_order_relaxed);
+
+    m_algMatrixSeq.store(seq + 2, std::memory_order_release);
+}
+
+void AudioPlugin2686V::applyOpzx7AlgMatrix(SynthParams& params)
+{
+    auto& matrix = params.opzx7.algFb.matrix;
+
+    // プラグインプロセッサから直接最新のマトリックス情報を引っ張ってくる
+    matrix.mode = getOpzx7AlgMode();
+
+    // 公開済みスナップショットをロックせずに読む (書き込みと重なったら読み直す)
+    juce::uint32 seq = 0;
+    juce::uint32 carrier = 0;
+    juce::uint64 mod = 0;
+    juce::uint64 fbMod = 0;
+
+    for (;;) {
+        seq = m_algMatrixSeq.load(std::memory_order_acquire);
+        if ((seq & 1u) != 0) {
+            // 書き込み中: 既に一度取得済みなら前の版のまま進め、次のブロックで拾う
+            if (matrix.version != 0) return;
+            continue;
+        }
+
+        // 前回と同じ版数ならマトリックス本体は既に反映済み
+        if (matrix.version == (seq >> 1)) return;
+
+        carrier = m_algMatrixCarrierBits.load(std::memory_order_relaxed);
+        mod = m_algMatrixModBits.load(std::memory_order_relaxed);
+        fbMod = m_algMatrixFbModBits.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_algMatrixSeq.load(std::memory_order_relaxed) == seq) break;
+    }
+
+    // DSP用に定義した AlgMatrixParams へ移し替える
+    for (int i = 0; i < 8; ++i) {
+        matrix.isCarrier[i] = (carrier >> i) & 1u;
+        for (int j = 0; j < 8; ++j) {
+            // UIで設定した値をそのままDSPの配列にマッピングする
+            const int bit = i * 8 + j;
+            matrix.mod[i][j] = (mod >> bit) & 1u;
+            matrix.fbMod[i][j] = (fbMod >> bit) & 1u;
+        }
+    }
+    matrix.version = seq >> 1;
+}
+
+SynthParams AudioPlugin2686V::buildSynthParams(OscMode mode)
+{
+    SynthParams params;
+    params.mode = mode;
+
+    prMap[mode]->processBlock(params, apvts);
+    prCurve.processBlock(params, apvts);
+
+    if (mode == OscMode::OPZX7) {
+        applyOpzx7AlgMatrix(params);
+    }
+
+    return params;
+}
+
 void AudioPlugin2686V::updateAlgMatrixCacheFromState()
 {
     // プロジェクトのロード時やプリセット読み込み時に呼ばれる想定
@@ -1536,4 +1969,6 @@ void AudioPlugin2686V::updateAlgMatrixCacheFromState()
             if (index < fStr.length()) m_opzx7AlgMatrixState.fbMod[i][j] = (fStr[index] == '1');
         }
     }
+
+    publishOpzx7AlgMatrix(m_opzx7AlgMatrixState);
 }
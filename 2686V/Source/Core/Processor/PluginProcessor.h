@@ -3,6 +3,7 @@
 #include <algorithm>
 
 #include "../Synth/SynthVoice.h"
+#include "../Synth/VoiceRenderPool.h"
 
 #include "../../Processor/Opna/ProcessorOpna.h"
 #include "../../Processor/Opn/ProcessorOpn.h"
@@ -43,6 +44,8 @@ private:
     juce::Array<int> heldNotes;
 public:
     RetroSynthesiser() : juce::Synthesiser() {
+        // MIDI イベントの位置でブロックを必ず分割する (既定の 32 サンプル単位だとノートの開始が最大 32 サンプル早まる)
+        setMinimumRenderingSubdivisionSize(1, true);
     }
 
     bool isMonoMode = false;
@@ -50,12 +53,31 @@ public:
     bool pitchResetOnLegato = false;
     float fixedVelocity = 1.0f;
     bool isMidiProcessing = false;
+    int unisonLimit = Global::unisonVoices; // ユニゾン数の上限 (設定画面で変更)
 
     SynthParams* currentParams = nullptr;
 
+    // 発音中のボイス (描画・パラメータ反映・発音判定はここに載っているボイスだけを見る)
+    ActiveVoiceList activeVoices;
+
+    // 発音中のボイスを作業スレッドで分担して描画する (作業スレッド数 0 なら使わない)
+    VoiceRenderPool renderPool;
+
+    // 発音中のボイスだけを描画し、鳴り終わったものを一覧から外す
+    void renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) override
+    {
+        if (!renderPool.render(activeVoices.begin(), activeVoices.size(), buffer, startSample, numSamples)) {
+            for (auto* voice : activeVoices) {
+                voice->renderNextBlock(buffer, startSample, numSamples);
+            }
+        }
+
+        activeVoices.removeInactive();
+    }
+
     void voiceUnison(int voices, int detune, float spread, int midiChannel, int midiNoteNumber, float velocity, bool isLegato)
     {
-        int uVoices = voices; // (※モードに応じて切り替えるように後で調整)
+        int uVoices = std::clamp(voices, 1, unisonLimit);
 
         if (!isMonoMode && uVoices <= 1) {
             if (auto* voice = dynamic_cast<SynthVoice*>(findFreeVoice(getSound(0).get(), midiChannel, midiNoteNumber, true))) {
@@ -271,12 +293,10 @@ public:
 
             // まだ押されているキーが残っているか？
             if (heldNotes.isEmpty()) {
-                // もう何も押されていないので、全ボイス(ユニゾン含む)を停止して音を消す
-                for (int i = 0; i < getNumVoices(); ++i) {
-                    if (auto* voice = getVoice(i)) {
-                        if (voice->isVoiceActive()) {
-                            voice->stopNote(targetVelocity, allowTailOff);
-                        }
+                // もう何も押されていないので、発音中の全ボイス(ユニゾン含む)を停止して音を消す
+                for (auto* voice : activeVoices) {
+                    if (voice->isVoiceActive()) {
+                        voice->stopNote(targetVelocity, allowTailOff);
                     }
                 }
             }
@@ -445,6 +465,39 @@ public:
         // ポリフォニック時(OFF)は、通常のJUCEの和音割り当て機能を使う
         return juce::Synthesiser::findFreeVoice(soundToPlay, midiChannel, midiNoteNumber, stealIfNoneAvailable);
     }
+
+    // 空きボイスが無い時に奪うボイスを選ぶ
+    // 鍵盤が離されてリリース中のボイスを優先し、その中で直近の出力が一番小さいもの (同じなら古いもの) を選ぶ
+    juce::SynthesiserVoice* findVoiceToSteal(juce::SynthesiserSound* soundToPlay,
+        int midiChannel,
+        int midiNoteNumber) const override
+    {
+        SynthVoice* best = nullptr;
+        bool bestReleased = false;
+
+        for (auto* voice : activeVoices) {
+            if (!voice->isVoiceActive() || !voice->canPlaySound(soundToPlay)) continue;
+
+            const bool released = voice->isPlayingButReleased();
+
+            if (best == nullptr || (released && !bestReleased)) {
+                best = voice;
+                bestReleased = released;
+                continue;
+            }
+
+            if (released != bestReleased) continue;
+
+            if (voice->getLevel() < best->getLevel() ||
+                (voice->getLevel() == best->getLevel() && voice->wasStartedBefore(*best))) {
+                best = voice;
+            }
+        }
+
+        if (best != nullptr) return best;
+
+        return juce::Synthesiser::findVoiceToSteal(soundToPlay, midiChannel, midiNoteNumber);
+    }
 };
 
 class AudioPlugin2686V : public juce::AudioProcessor
@@ -466,9 +519,49 @@ private:
 
     CurveCore m_curveCore;
 
+    // サンプルの受け渡し口 (0 ~ pads - 1: Rhythm の各パッド, pads: ADPCM)
+    static constexpr int adpcmPcmSlot = RhythmPrValue::pads;
+    struct PcmSlot
+    {
+        std::atomic<PcmSample*> published{ nullptr }; // 読み込み完了済みの最新サンプル
+        std::atomic<PcmSample*> applied{ nullptr };   // オーディオスレッドがボイスに設定したサンプル
+        std::atomic<int> serial{ 0 };                 // 最新の要求番号 (追い越された読み込み結果は捨てる)
+    };
+    std::array<PcmSlot, RhythmPrValue::pads + 1> m_pcmSlots;
+
+    // published / applied のどちらかで参照中のサンプルを保持する
+    juce::CriticalSection m_pcmRetainLock;
+    juce::ReferenceCountedArray<PcmSample> m_pcmRetained;
+
+    void requestPcmSample(int slotIndex, const juce::File& file, const QualityPcmParams& quality, double targetRate);
+    void publishPcmSample(int slotIndex, int serial, PcmSample::Ptr sample);
+    void applyPcmSamples();
+    void releaseUnusedPcmSamples();
+    void encodePendingPcmSamples();
+
     SynthParams m_currentParams;
     SynthParams m_previewParams;
 
+    // ボイスへ最後に送ったパラメータのスナップショットとバージョン
+    // (変化したセクションがある時だけバージョンを進め、ボイスはバージョン差分がある時だけ反映する)
+    SynthParams m_pushedParams;
+    uint32_t m_paramVersion = 1;
+
+    bool updateParamSnapshot();
+
+    int m_polyphony = Global::voices;
+    int m_unisonLimit = Global::unisonVoices;
+    int m_renderThreads = Global::RenderThreads::initial;
+    std::atomic<int> m_resampleQuality{ Global::ResampleQuality::initial }; // processBlock で SynthParams へ写す
+    std::atomic<bool> m_oscAntialias{ false }; // 同上
+    int m_maxBlockSize = 0; // prepareToPlay で受け取ったブロック長 (releaseResources 後は 0)
+
+    SynthVoice* createVoice();
+
+    // 無音が続いた長さ (FX のテールを鳴らし切ったら FX ごと処理を止める)
+    juce::int64 m_silentSamples = 0;
+    bool m_fxSuspended = false;
+
     std::atomic<float>* pMode = nullptr;
     std::atomic<float>* pMonoMode = nullptr;
     std::atomic<float>* pUseVelocity = nullptr;
@@ -486,6 +579,30 @@ private:
     std::unique_ptr<SynthSound> previewSound;
     FxProcessor previewFx;
 
+    // 静的プレビューの描画スレッド
+    // 要求で起き、パラメータのハッシュが前回と違う時だけ描画し直す
+    class PreviewThread : public juce::Thread
+    {
+    public:
+        explicit PreviewThread(AudioPlugin2686V& p) : juce::Thread("WaveformPreview"), owner(p) {}
+        void run() override;
+    private:
+        AudioPlugin2686V& owner;
+    };
+
+    PreviewThread m_previewThread{ *this };
+    juce::CriticalSection m_previewRenderLock;     // 描画中に prepareToPlay で作り直されないようにする
+    juce::SpinLock m_previewPublishLock;
+    std::vector<float> m_previewWaveform;          // 完成した波形 (m_previewPublishLock で保護)
+    std::atomic<int> m_previewVersion{ 0 };
+    std::atomic<int> m_previewContentVersion{ 0 }; // SynthParams 以外 (カーブ, OPZX7 の PCM/波形メモリ) の変更回数
+    juce::uint64 m_previewHash = 0;                // 描画スレッドのみが触る
+
+    void collectPreviewParams();
+    juce::uint64 computePreviewHash();
+    void renderPreviewIfChanged();
+    void generatePreviewWaveform(std::vector<float>* destBuffer);
+
     void loadStartupSettings(); // 設定の自動読み込み用関数
     void setPresetToXml(std::unique_ptr<juce::XmlElement>& xml);
     void getPresetFromXml(std::unique_ptr<juce::XmlElement>& xmlState);
@@ -545,6 +662,10 @@ public:
     juce::String adpcmFilePath;
     std::array<juce::String, RhythmPrValue::pads> rhythmFilePaths;
 
+    // --- ADPCM / Rhythm Samples (全ボイスで共有) ---
+    // 読み込みはプールのスレッドで行い、オーディオスレッドはポインタを差し替えるだけ
+    GenPcmPool pcmPool{ formatManager };
+
     // --- Preset I/O ---
     void savePreset(const juce::File& file);
     void loadPreset(const juce::File& file);
@@ -574,7 +695,10 @@ public:
     void unloadOpzx7Wt2File(int opIndex);
 
     // --- Preview(Static) ---
-    void generatePreviewWaveform(std::vector<float>* destBuffer);
+    // 描画は専用スレッドで行う。エディタはタイマーで要求し、完成した波形だけを受け取る
+    void requestPreviewWaveform();
+    // lastVersion より新しい波形があれば dest にコピーして true を返す
+    bool getPreviewWaveform(std::vector<float>& dest, int& lastVersion);
 
     // --- 仮想キーボード ---
     juce::MidiKeyboardState keyboardState;
@@ -622,6 +746,25 @@ public:
 
     void panic();
 
+    // 同時発音数とユニゾン上限 (プロジェクトごとに保存される)
+    // ボイスの確保し直しは処理を一時停止して行うので、メッセージスレッドから呼ぶこと
+    int getPolyphony() const { return m_polyphony; }
+    int getUnisonLimit() const { return m_unisonLimit; }
+    void setVoiceLimits(int polyphony, int unisonLimit);
+
+    // ボイス描画の作業スレッド数 (0 ならオーディオスレッドだけで描画する、プロジェクトごとに保存される)
+    // 作業スレッドの作り直しは処理を一時停止して行うので、メッセージスレッドから呼ぶこと
+    int getRenderThreads() const { return m_renderThreads; }
+    void setRenderThreads(int numThreads);
+
+    // 仮想サンプリングレートからホストのレートへの変換品質 (Global::ResampleQuality、プロジェクトごとに保存される)
+    int getResampleQuality() const { return m_resampleQuality.load(); }
+    void setResampleQuality(int quality);
+
+    // SSG / Beep の矩形波・三角波を PolyBLEP で帯域制限するか (既定はオフ = 実機どおりの折り返しを残す、プロジェクトごとに保存される)
+    bool getOscAntialias() const { return m_oscAntialias.load(); }
+    void setOscAntialias(bool shouldAntialias) { m_oscAntialias.store(shouldAntialias); }
+
     juce::String makePathRelative(const juce::File& targetFile); // 相対ディレクトリへ変換
     juce::File resolvePath(const juce::String& pathStr); // 相対ディレクトリからの展開
     juce::String makeWtPathRelative(const juce::File& targetFile); // 相対ディレクトリへ変換
@@ -633,6 +776,9 @@ public:
     static juce::String sanitizeString(const juce::String& input, int length);
     CurveCore* getCurveCore();
 
+    // 現在のパラメータから mode 用の SynthParams を組み立てる (ツールからコアを直接鳴らす時用)
+    SynthParams buildSynthParams(OscMode mode);
+
     void bakeCurves();
     void bakeCurvesPrim(int positionIndex, int targetIndex, int paramIndex);
     void resetMidiSettings();
@@ -657,8 +803,21 @@ public:
 private:
     // オーディオスレッドから安全に読み取るためのキャッシュ
     std::atomic<int> m_opzx7AlgMode{ 0 };
-    AlgMatrixState m_opzx7AlgMatrixState;
-    juce::CriticalSection m_matrixLock; // マトリックス配列読み書き時のスレッドセーフ用
+    AlgMatrixState m_opzx7AlgMatrixState; // GUI/メッセージスレッド側の原本
+    juce::CriticalSection m_matrixLock; // 原本の書き込み同士の排他用 (オーディオスレッドは取らない)
+
+    // オーディオスレッド向けのロックフリーな公開スナップショット (シーケンスロック)
+    // 書き込み中は m_algMatrixSeq が奇数になり、読み手は前後で値が一致するまで読み直す
+    // 版数は m_algMatrixSeq / 2 (0 は AlgMatrixParams の「未取得」を表すので 1 から始める)
+    std::atomic<juce::uint32> m_algMatrixSeq{ 2 };
+    std::atomic<juce::uint32> m_algMatrixCarrierBits{ 0 };
+    std::atomic<juce::uint64> m_algMatrixModBits{ 0 };
+    std::atomic<juce::uint64> m_algMatrixFbModBits{ 0 };
+
+    void publishOpzx7AlgMatrix(const AlgMatrixState& state);
+
+    // マトリックスの状態を SynthParams (DSP用) へ移し替える (版数が同じならコピーしない)
+    void applyOpzx7AlgMatrix(SynthParams& params);
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPlugin2686V)
 };
@@ -2,6 +2,8 @@
 
 #include <JuceHeader.h>
 #include <array>
+#include <cstring>
+#include <type_traits>
 
 #include "./ProcessorStructs.h"
 #include "./ProcessorKeys.h"
@@ -1255,6 +1257,38 @@ namespace PrHelper {
 		}
 	}
 
+	// apply* で更新したパラメータ構造体を前回ボイスへ送った値と比較し、変化があればスナップショットを更新して true を返す
+	// パラメータ構造体はすべて POD なのでバイト比較で判定する (スナップショットは memcpy で取るためパディングも一致する)
+	template <typename T>
+	static inline bool updateSnapshot(const T& current, T& snapshot){
+		static_assert(std::is_trivially_copyable_v<T>, "Parameter structs must be trivially copyable");
+
+		if (std::memcmp(&current, &snapshot, sizeof(T)) == 0) return false;
+
+		std::memcpy(&snapshot, &current, sizeof(T));
+		return true;
+	}
+
+	// パラメータ構造体のバイト列のハッシュ (FNV-1a)。updateSnapshot と同じくバイト単位で扱う
+	static inline juce::uint64 hashBytes(const void* data, size_t size, juce::uint64 seed = 14695981039346656037ull){
+		auto* bytes = static_cast<const juce::uint8*>(data);
+		juce::uint64 hash = seed;
+
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	template <typename T>
+	static inline juce::uint64 hashStruct(const T& value, juce::uint64 seed = 14695981039346656037ull){
+		static_assert(std::is_trivially_copyable_v<T>, "Parameter structs must be trivially copyable");
+
+		return hashBytes(&value, sizeof(T), seed);
+	}
+
 	static inline void addFloat(juce::AudioProcessorValueTreeState::ParameterLayout& layout, const juce::String& code, const juce::String& name, float min, float max, float ini) {
 		layout.add(std::make_unique<juce::AudioParameterFloat>(code, name, min, max, ini));
 	}
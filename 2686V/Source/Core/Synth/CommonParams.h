@@ -39,6 +39,10 @@ struct AlgMatrixParams {
 
     // フィードバック指定 (src から dest への逆方向/自己接続 src >= dest)
     std::array<std::array<bool, 8>, 8> fbMod = { false };
+
+    // プロセッサが公開したマトリックスの版数 (0: 未取得)
+    // 版数が変わった時だけ各ボイスのルーティングキャッシュを作り直す
+    unsigned int version = 0;
 };
 
 struct AlgFbParams {
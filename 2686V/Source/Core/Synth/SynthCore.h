@@ -16,6 +16,9 @@ public:
     void virtual setPitchBendRatio(float ratio) {};
     void virtual setModulationWheel(int wheelValue) {};
     float virtual getSample() { return 0.0f; };
-    void virtual renderNextBlock(float * outR, float* outL, int startSample, int sampleIdx, bool& isActive) {};
+    // startSample から numSamples 分をまとめて加算する (コアの解決はブロック毎に1回)
+    // 発音が終了した時点でループを抜け、isActive = false を返す
+    // 各コアは final クラスとしてこれを実装するので、内部の getSample() / isPlaying() は仮想呼び出しにならずインライン化される
+    void virtual renderNextBlock(float * outR, float* outL, int startSample, int numSamples, bool& isActive) {};
     void virtual setUnisonParams(int index, int total, float detune, float spread) {};
 };
\ No newline at end of file
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// 毎サンプルの AM (dB → ゲイン) / PM (cent → 周波数比) 用の 2^x 高速近似
+//
+// 2^x = 2^n * p(f) (n = round(x), f = x - n ∈ [-0.5, 0.5]) とし、2^n は指数部を直接組み立て、
+// p(f) は 2^f の 5 次最小最大近似多項式で求める (テーブルを持たないので、キャッシュを汚さない)
+//
+// 誤差 (実測):
+//   exp2         : double の 2^x に対して相対誤差 2.4e-7 以下 (x ∈ [-40, 40], float の 2ULP 程度)
+//   dbToGain     : std::pow(10.0f, db / 20.0f) に対して 1.2e-5 dB 以下 (db ∈ [-120, 120])
+//   centsToRatio : std::pow(2.0f, cents / 1200.0f) に対して 7.2e-4 cent 以下 (cents ∈ [-4800, 4800])
+// (後の 2 つは float の入力丸めが支配的で、いずれも可聴域を大きく下回る)
+namespace FastMath
+{
+    inline constexpr float minExponent = -126.0f; // これより小さい値は非正規化数になるので丸める
+    inline constexpr float maxExponent = 127.0f;
+    inline constexpr float log2Of10Div20 = 0.166096404744368f; // log2(10) / 20
+
+    inline float exp2(float x) noexcept
+    {
+        x = std::clamp(x, minExponent, maxExponent);
+
+        const float n = std::floor(x + 0.5f);
+        const float f = x - n;
+
+        // 2^f (f ∈ [-0.5, 0.5]) の最小最大近似 (相対誤差の最大値を均した係数)
+        const float p = 1.000000119e+00f + f * (6.931469440e-01f + f * (2.402212024e-01f
+            + f * (5.550713092e-02f + f * (9.675541893e-03f + f * 1.327647245e-03f))));
+
+        // 2^n は IEEE754 の指数部に n + 127 を入れて作る
+        const std::uint32_t bits = (std::uint32_t)((int)n + 127) << 23;
+        return p * std::bit_cast<float>(bits);
+    }
+
+    // std::pow(2.0f, cents / 1200.0f) の置き換え
+    inline float centsToRatio(float cents) noexcept { return exp2(cents * (1.0f / 1200.0f)); }
+
+    // std::pow(2.0f, semitones / 12.0f) の置き換え
+    inline float semitonesToRatio(float semitones) noexcept { return exp2(semitones * (1.0f / 12.0f)); }
+
+    // std::pow(10.0f, db / 20.0f) の置き換え
+    inline float dbToGain(float db) noexcept { return exp2(db * log2Of10Div20); }
+}
@@ -3,6 +3,7 @@
 #include <array>
 
 #include "./SynthMode.h"
+#include "../Const/ConstGlobal.h"
 
 #include "../../Synth/Opna/SynthOpnaParams.h"
 #include "../../Synth/Opn/SynthOpnParams.h"
@@ -29,6 +30,12 @@ struct SynthParams
     bool pitchResetOnLegato = false;
     float fixedVelocity = 1.0f;
 
+    // --- Virtual Rate Conversion --- (設定画面の値、プリセットには含まない)
+    int resampleQuality = Global::ResampleQuality::initial;
+
+    // --- Oscillator Anti-aliasing --- (設定画面の値、プリセットには含まない / SSG・Beep のみ)
+    bool oscAntialias = false;
+
     OpnaParams opna;
     OpnParams opn;
     OplParams opl;
@@ -0,0 +1,255 @@
+﻿#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "./SynthResampler.h"
+
+namespace
+{
+    struct KernelSpec
+    {
+        int zeroCrossings; // 片側のゼロクロス数 (遅れとタップ数を決める)
+        double rolloff;    // ナイキストに対するカットオフ (折り返し手前で落とし切るため 1 未満にする)
+        double beta;       // Kaiser 窓の β (阻止域の減衰量)
+    };
+
+    // Linear は使わないのでダミー
+    constexpr std::array<KernelSpec, VirtualRateResampler::QualityCount> kernelSpecs{ {
+        { 1, 1.0, 0.0 },
+        { 8, 0.90, 7.0 },
+        { 16, 0.94, 9.0 },
+    } };
+
+    constexpr int tableResolution = 512; // プロトタイプの表の 1 サンプル間隔あたりの点数
+    constexpr int tablePadding = 3;      // 引き伸ばした時にはみ出す分 (この範囲は 0 なので分岐せずに引ける)
+    constexpr int polyphaseCount = 128;  // 整数比でない時の位相の分割数 (隣り合う位相の係数を直線補間する)
+    constexpr int maxFixedRatio = 48;    // 整数比の係数を用意するホスト / 仮想レート比の上限
+
+    // 0 次の第 1 種変形ベッセル関数 (Kaiser 窓用の級数展開)
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        const double halfX = x * 0.5;
+        for (int k = 1; k < 50; ++k) {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+            if (term < sum * 1.0e-12) break;
+        }
+        return sum;
+    }
+
+    struct KernelBank
+    {
+        // prototype[q][i] = h(i / tableResolution)
+        std::array<std::vector<float>, VirtualRateResampler::QualityCount> prototype;
+        // polyphase[q] = (polyphaseCount + 1) 位相 * (2 * ゼロクロス数 + 1) タップ
+        std::array<std::vector<float>, VirtualRateResampler::QualityCount> polyphase;
+        // fixed[q][M] = M 位相 * (2 * ゼロクロス数 + 1) タップ
+        std::array<std::array<std::vector<float>, maxFixedRatio + 1>, VirtualRateResampler::QualityCount> fixed;
+
+        KernelBank()
+        {
+            for (int q = VirtualRateResampler::Standard; q < VirtualRateResampler::QualityCount; ++q) {
+                const auto& spec = kernelSpecs[(size_t)q];
+                const int length = spec.zeroCrossings * tableResolution;
+                auto& table = prototype[(size_t)q];
+                table.assign((size_t)(length + tablePadding * tableResolution), 0.0f);
+
+                const double norm = 1.0 / besselI0(spec.beta);
+                for (int i = 0; i < length; ++i) {
+                    const double x = (double)i / tableResolution;
+                    const double t = x / spec.zeroCrossings;
+                    const double window = besselI0(spec.beta * std::sqrt(1.0 - t * t)) * norm;
+                    const double arg = juce::MathConstants<double>::pi * spec.rolloff * x;
+                    const double sinc = (i == 0) ? 1.0 : std::sin(arg) / arg;
+                    table[(size_t)i] = (float)(spec.rolloff * sinc * window);
+                }
+
+                const int delay = spec.zeroCrossings;
+                const int taps = 2 * delay + 1;
+
+                // 直近のサンプルから offset 進んだ時刻の係数 (古い順、合計は 1 に正規化して直流の揺れを無くす)
+                auto fillPhase = [&](float* c, double offset) {
+                    double sum = 0.0;
+                    for (int k = 0; k < taps; ++k) {
+                        const double pos = std::abs(offset - delay + (taps - 1 - k)) * tableResolution;
+                        const int i = (int)pos;
+                        const double h = (i + 1 < (int)table.size()) ? table[(size_t)i] + (table[(size_t)i + 1] - table[(size_t)i]) * (pos - i) : 0.0;
+                        c[k] = (float)h;
+                        sum += h;
+                    }
+                    if (sum != 0.0) {
+                        for (int k = 0; k < taps; ++k) c[k] = (float)(c[k] / sum);
+                    }
+                };
+
+                auto& phases = polyphase[(size_t)q];
+                phases.assign((size_t)((polyphaseCount + 1) * taps), 0.0f);
+                for (int phase = 0; phase <= polyphaseCount; ++phase) {
+                    fillPhase(phases.data() + phase * taps, (double)phase / polyphaseCount);
+                }
+
+                for (int ratio = 2; ratio <= maxFixedRatio; ++ratio) {
+                    auto& coefs = fixed[(size_t)q][(size_t)ratio];
+                    coefs.assign((size_t)(ratio * taps), 0.0f);
+                    for (int phase = 0; phase < ratio; ++phase) {
+                        fillPhase(coefs.data() + phase * taps, (double)phase / ratio);
+                    }
+                }
+            }
+        }
+    };
+
+    const KernelBank& getKernelBank()
+    {
+        static const KernelBank bank;
+        return bank;
+    }
+
+    // 積和の依存の連鎖を 4 本に分けて、加算の待ち時間で詰まらないようにする
+    inline float dotProduct(const float* x, const float* c, int n) noexcept
+    {
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+        int k = 0;
+        for (; k + 4 <= n; k += 4) {
+            s0 += x[k] * c[k];
+            s1 += x[k + 1] * c[k + 1];
+            s2 += x[k + 2] * c[k + 2];
+            s3 += x[k + 3] * c[k + 3];
+        }
+        for (; k < n; ++k) {
+            s0 += x[k] * c[k];
+        }
+        return (s0 + s1) + (s2 + s3);
+    }
+}
+
+void VirtualRateResampler::prepare()
+{
+    getKernelBank();
+
+    // ホストのレートが変わっていなくても次の configure で設定し直す
+    m_virtualRate = 0.0;
+    m_hostRate = 0.0;
+    reset();
+}
+
+void VirtualRateResampler::reset()
+{
+    m_history.fill(0.0f);
+    m_writePos = 0;
+}
+
+void VirtualRateResampler::configure(double virtualRate, double hostRate, int quality)
+{
+    quality = std::clamp(quality, (int)Linear, (int)QualityCount - 1);
+
+    if (quality == m_quality && virtualRate == m_virtualRate && hostRate == m_hostRate) return;
+
+    m_quality = quality;
+    m_virtualRate = virtualRate;
+    m_hostRate = hostRate;
+
+    m_delay = 0;
+    m_taps = 1;
+    m_cutoff = 1.0f;
+    m_fixedRatio = 0;
+    m_phaseCoefs = nullptr;
+    m_kernel = nullptr;
+
+    if (quality == Linear || virtualRate <= 0.0 || hostRate <= 0.0) return;
+
+    const auto& bank = getKernelBank();
+    const auto& spec = kernelSpecs[(size_t)quality];
+    const double ratio = hostRate / virtualRate;
+
+    if (ratio >= 1.0) {
+        m_delay = spec.zeroCrossings;
+        m_taps = 2 * m_delay + 1;
+
+        // ホストのレートが仮想レートの整数倍なら、位相は M 通りしかないので補間せずに係数を使う
+        const double rounded = std::round(ratio);
+        if (rounded <= maxFixedRatio && std::abs(ratio - rounded) < 1.0e-9) {
+            m_fixedRatio = (int)rounded;
+
+            // 同じレートなら変換は要らない
+            if (m_fixedRatio == 1) {
+                m_delay = 0;
+                m_taps = 1;
+                return;
+            }
+
+            m_phaseCoefs = bank.fixed[(size_t)quality][(size_t)m_fixedRatio].data();
+            return;
+        }
+
+        m_phaseCoefs = bank.polyphase[(size_t)quality].data();
+        return;
+    }
+
+    // 仮想レートの方が高い時は、ホストのナイキストで切るようにカーネルを引き伸ばす (その分タップが増える)
+    m_kernel = bank.prototype[(size_t)quality].data();
+    m_cutoff = (float)ratio;
+    m_delay = std::min(maxDelay, (int)std::ceil(spec.zeroCrossings / m_cutoff));
+    m_cutoff = std::max(m_cutoff, (float)spec.zeroCrossings / (float)m_delay); // 履歴に収まらない分はカットオフを上げて妥協する
+    m_taps = 2 * m_delay + 1;
+}
+
+float VirtualRateResampler::read(double elapsed) const noexcept
+{
+    if (m_fixedRatio == 1) return m_history[(size_t)m_writePos];
+    if (m_fixedRatio > 0) return readFixed(elapsed);
+    if (m_kernel == nullptr) return readPolyphase(elapsed);
+    return readStretched(elapsed);
+}
+
+float VirtualRateResampler::readFixed(double elapsed) const noexcept
+{
+    // 累積誤差で 1 に届きかけた位相は最後の位相に丸める
+    const int phase = std::min((int)(elapsed * m_fixedRatio + 0.5), m_fixedRatio - 1);
+    const float* coefs = m_phaseCoefs + phase * m_taps;
+    const float* x = m_history.data() + m_writePos + historySize - (m_taps - 1); // 古い順
+
+    return dotProduct(x, coefs, m_taps);
+}
+
+float VirtualRateResampler::readPolyphase(double elapsed) const noexcept
+{
+    const float pos = (float)std::clamp(elapsed, 0.0, 1.0) * (float)polyphaseCount;
+    const int phase = std::min((int)pos, polyphaseCount - 1);
+    const float frac = pos - (float)phase;
+
+    const float* a = m_phaseCoefs + phase * m_taps;
+    const float* b = a + m_taps;
+    const float* x = m_history.data() + m_writePos + historySize - (m_taps - 1); // 古い順
+
+    // 両隣の位相で畳み込んでから補間する (係数を作り直すより安く、ベクトル化しやすい)
+    const float sumA = dotProduct(x, a, m_taps);
+    const float sumB = dotProduct(x, b, m_taps);
+    return sumA + (sumB - sumA) * frac;
+}
+
+float VirtualRateResampler::readStretched(double elapsed) const noexcept
+{
+    const float* x = m_history.data() + m_writePos + historySize - (m_taps - 1); // 古い順
+
+    // k 番目のタップと出力時刻の距離 (仮想サンプル単位) は first - k
+    // 距離の符号が変わる所で分け、絶対値を取らずに表を引く (表の末尾は 0 で埋めてあるので範囲外の判定も要らない)
+    const float first = (float)(elapsed - m_delay + (m_taps - 1));
+    const float scale = m_cutoff * (float)tableResolution;
+    const int split = std::min(m_taps, (int)first + 1);
+
+    float sum = 0.0f;
+    for (int k = 0; k < split; ++k) {
+        const float pos = (first - (float)k) * scale;
+        const int i = (int)pos;
+        sum += x[k] * (m_kernel[i] + (m_kernel[i + 1] - m_kernel[i]) * (pos - (float)i));
+    }
+    for (int k = split; k < m_taps; ++k) {
+        const float pos = ((float)k - first) * scale;
+        const int i = (int)pos;
+        sum += x[k] * (m_kernel[i] + (m_kernel[i + 1] - m_kernel[i]) * (pos - (float)i));
+    }
+    return sum * m_cutoff;
+}
@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+// 仮想サンプリングレートで生成した波形をホストのレートへ変換する (コアごとに 1 つ持つ)
+// Linear は従来どおりコア側の直線補間を使い、Standard / High は窓付き sinc で帯域制限して補間する
+// (直線補間では仮想レートの整数倍の位置にイメージが残り、低いレートほど耳につく)
+class VirtualRateResampler
+{
+public:
+    enum Quality
+    {
+        Linear = 0,
+        Standard,   // 片側 8 ゼロクロス
+        High,       // 片側 16 ゼロクロス
+        QualityCount
+    };
+
+    // 係数表を用意して履歴を消す (prepareToPlay から呼ばれる経路で呼び、オーディオスレッドでの初回構築を避ける)
+    void prepare();
+    void reset();
+
+    // レートや品質が変わった時だけ設定し直す (ブロック先頭で毎回呼んでよい、メモリ確保はしない)
+    void configure(double virtualRate, double hostRate, int quality);
+
+    bool isBandLimited() const noexcept { return m_quality != Linear; }
+
+    // 仮想レートで 1 サンプル生成するたびに呼ぶ
+    void push(float sample) noexcept
+    {
+        m_writePos = (m_writePos + 1) & (historySize - 1);
+        m_history[m_writePos] = sample;
+        m_history[m_writePos + historySize] = sample;
+    }
+
+    // 最後に push したサンプルから elapsed (仮想サンプル単位) 進んだ時刻の値を、getLatency() 分遅らせて返す
+    float read(double elapsed) const noexcept;
+
+    // 帯域制限による遅れ (仮想サンプル数)
+    int getLatency() const noexcept { return m_delay; }
+
+private:
+    static constexpr int historySize = 128;          // 2 のべき乗 (タップ数の上限を兼ねる)
+    static constexpr int maxDelay = (historySize - 1) / 2;
+
+    // 末尾側をもう 1 周分複製しておき、直近 historySize 個をいつでも連続で読めるようにする
+    std::array<float, historySize * 2> m_history{};
+    int m_writePos = 0;
+
+    int m_quality = Linear;
+    double m_virtualRate = 0.0;
+    double m_hostRate = 0.0;
+
+    int m_delay = 0;          // 出力の遅れ (仮想サンプル)
+    int m_taps = 1;           // 2 * m_delay + 1
+    float m_cutoff = 1.0f;    // 仮想レートのナイキストに対するカットオフ比 (ホストの方が低い時は 1 未満)
+    int m_fixedRatio = 0;     // ホスト / 仮想レートが整数の時の比 (0 なら整数比ではない)
+    const float* m_phaseCoefs = nullptr; // 位相ごとの係数 [位相][タップ] (整数比なら M 位相、それ以外の補間用は 129 位相)
+    const float* m_kernel = nullptr;     // 仮想レートの方が高い時に引き伸ばして引くプロトタイプ (窓付き sinc) の表
+
+    float readFixed(double elapsed) const noexcept;
+    float readPolyphase(double elapsed) const noexcept;
+    float readStretched(double elapsed) const noexcept;
+};
@@ -0,0 +1,43 @@
+﻿#pragma once
+#include <JuceHeader.h>
+
+// ======================================================
+// ボイス出力のゲイン (レベル × パン × ユニゾン補正) をサンプル単位で補間する
+// パラメータはブロック先頭でしか届かないので、そのまま掛けるとブロック境界で段差 (ジッパーノイズ) になる
+// ======================================================
+class StereoGainSmoother
+{
+public:
+    static constexpr double rampSeconds = 0.02;
+
+    void prepare(double sampleRate)
+    {
+        left.reset(sampleRate, rampSeconds);
+        right.reset(sampleRate, rampSeconds);
+        m_snap = true;
+    }
+
+    // 新しく発音する時は前の音の値から補間せず、次の setTarget() で目標値に揃える
+    void restart() noexcept { m_snap = true; }
+
+    void setTarget(float gainL, float gainR) noexcept
+    {
+        if (m_snap) {
+            left.setCurrentAndTargetValue(gainL);
+            right.setCurrentAndTargetValue(gainR);
+            m_snap = false;
+            return;
+        }
+
+        left.setTargetValue(gainL);
+        right.setTargetValue(gainR);
+    }
+
+    bool isSmoothing() const noexcept { return left.isSmoothing() || right.isSmoothing(); }
+
+    juce::SmoothedValue<float> left;
+    juce::SmoothedValue<float> right;
+
+private:
+    bool m_snap = true;
+};
@@ -1,4 +1,21 @@
-﻿#include "./SynthVoice.h"
+﻿#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "./SynthVoice.h"
+
+void ActiveVoiceList::add(SynthVoice* voice)
+{
+    voices.addIfNotAlreadyThere(voice);
+    numActive.store(voices.size(), std::memory_order_relaxed);
+}
+
+void ActiveVoiceList::removeInactive()
+{
+    voices.removeIf([](SynthVoice* voice) { return !voice->isVoiceActive(); });
+    numActive.store(voices.size(), std::memory_order_relaxed);
+}
 
 SynthVoice::SynthVoice()
 {
@@ -14,6 +31,8 @@ SynthVoice::SynthVoice()
     coreMap[OscMode::RHYTHM] = &m_rhythmCore;
     coreMap[OscMode::ADPCM] = &m_adpcmCore;
     coreMap[OscMode::BEEP] = &m_beepCore;
+
+    m_activeCore = coreMap[m_mode];
 }
 
 void SynthVoice::prepare(double sampleRate) {
@@ -33,19 +52,29 @@ void SynthVoice::prepare(double sampleRate) {
 
 void SynthVoice::setParameters(const SynthParams& params)
 {
-    m_mode = params.mode;
-    m_opnaCore.setParameters(params);
-    m_opnCore.setParameters(params);
-    m_oplCore.setParameters(params);
-    m_opl3Core.setParameters(params);
-    m_opmCore.setParameters(params);
-    m_opzx7Core.setParameters(params);
-    m_ssgCore.setParameters(params);
-    m_wtCore.setParameters(params);
-    m_wt2Core.setParameters(params);
-    m_rhythmCore.setParameters(params);
-    m_adpcmCore.setParameters(params);
-    m_beepCore.setParameters(params);
+    if (m_mode != params.mode) {
+        m_mode = params.mode;
+        m_activeCore = coreMap[m_mode];
+    }
+
+    // 非アクティブなコアには送らない (モード切替時にバージョンが変わるので、その時点で反映される)
+    m_activeCore->setParameters(params);
+}
+
+void SynthVoice::setParameterSource(const SynthParams* params, const uint32_t* version)
+{
+    m_paramSource = params;
+    m_paramSourceVersion = version;
+    m_appliedParamVersion = 0;
+}
+
+void SynthVoice::syncParameters()
+{
+    if (m_paramSource == nullptr || m_paramSourceVersion == nullptr) return;
+    if (m_appliedParamVersion == *m_paramSourceVersion) return;
+
+    setParameters(*m_paramSource);
+    m_appliedParamVersion = *m_paramSourceVersion;
 }
 
 void SynthVoice::startNote(int midiNote, float velocity, juce::SynthesiserSound*, int)
@@ -53,25 +82,25 @@ void SynthVoice::startNote(int midiNote, float velocity, juce::SynthesiserSound*
     // 周波数計算
     auto cyclesPerSecond = juce::MidiMessage::getMidiNoteInHertz(midiNote);
 
-    coreMap[m_mode]->noteOn(cyclesPerSecond, velocity, midiNote);
+    // 停止中に変更されたパラメータをここで反映する
+    syncParameters();
+
+    m_activeCore->noteOn(cyclesPerSecond, velocity, midiNote);
+
+    // まだ描画していないボイスが同じノートオンのユニゾンで奪われないよう、最大音量扱いにしておく
+    m_level = std::numeric_limits<float>::max();
+
+    if (m_activeList != nullptr) {
+        m_activeList->add(this);
+    }
 }
 
 void SynthVoice::stopNote(float, bool allowTailOff)
 {
     if (allowTailOff)
     {
-        m_opnaCore.noteOff();
-        m_opnCore.noteOff();
-        m_oplCore.noteOff();
-        m_opl3Core.noteOff();
-        m_opmCore.noteOff();
-        m_opzx7Core.noteOff();
-        m_ssgCore.noteOff();
-        m_wtCore.noteOff();
-        m_wt2Core.noteOff();
-        m_rhythmCore.noteOff();
-        m_adpcmCore.noteOff();
-        m_beepCore.noteOff();
+        // 発音しているのはアクティブなコアだけなので、他のコアには触れない
+        m_activeCore->noteOff();
     }
     else
     {
@@ -86,19 +115,29 @@ void SynthVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int sta
     float* outL = outputBuffer.getWritePointer(0);
     float* outR = outputBuffer.getWritePointer(1);
 
-    for (int i = 0; i < numSamples; ++i)
-    {
-        float sample = 0.0f;
+    // コアは出力へ足し込むので、描画前後の差分をまばらに覗いてこのボイスの大きさとする
+    const int probeStride = std::max(1, numSamples / levelProbes);
+    std::array<float, levelProbes + 1> before;
+    int probes = 0;
+    for (int i = 0; i < numSamples && probes < (int)before.size(); i += probeStride) {
+        before[probes++] = outL[startSample + i] + outR[startSample + i];
+    }
+
+    // コアの解決はブロック毎に1回だけ行い、サンプルループはコア側で回す
+    bool isActive = false;
 
-        bool isActive = false;
+    m_activeCore->renderNextBlock(outR, outL, startSample, numSamples, isActive);
 
-        coreMap[m_mode]->renderNextBlock(outR, outL, startSample, i, isActive);
+    float level = 0.0f;
+    for (int p = 0; p < probes; ++p) {
+        const int i = startSample + p * probeStride;
+        level = std::max(level, std::abs(outL[i] + outR[i] - before[p]));
+    }
+    m_level = level;
 
-        if (!isActive)
-        {
-            clearCurrentNote();
-            break;
-        }
+    if (!isActive)
+    {
+        clearCurrentNote();
     }
 }
 
@@ -126,7 +165,7 @@ void SynthVoice::setCurrentPlaybackSampleRate(double newRate)
 // ピッチベンド
 void SynthVoice::pitchWheelMoved(int newPitchWheelValue)
 {
-    coreMap[m_mode]->setPitchBend(newPitchWheelValue);
+    m_activeCore->setPitchBend(newPitchWheelValue);
 }
 
 void SynthVoice::controllerMoved(int controllerNumber, int newControllerValue)
@@ -134,7 +173,7 @@ void SynthVoice::controllerMoved(int controllerNumber, int newControllerValue)
     // CC #1 = Modulation Wheel
     if (controllerNumber == 1)
     {
-        coreMap[m_mode]->setModulationWheel(newControllerValue);
+        m_activeCore->setModulationWheel(newControllerValue);
     }
 }
 
@@ -186,5 +225,5 @@ void SynthVoice::setCurveCore(CurveCore* p_curveCore)
 
 bool SynthVoice::isPlaying()
 {
-    return coreMap[m_mode]->isPlaying();
+    return m_activeCore->isPlaying();
 }
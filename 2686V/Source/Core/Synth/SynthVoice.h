@@ -27,6 +27,33 @@ public:
     bool appliesToChannel(int) override { return true; }
 };
 
+class SynthVoice;
+
+// 発音中のボイスの一覧 (シンセサイザーが所有し、ボイスは発音開始時に自分を登録する)
+// 追加・削除はオーディオスレッドからのみ行い、他のスレッドは発音数だけを参照する
+class ActiveVoiceList
+{
+public:
+    void reserve(int numVoices) { voices.ensureStorageAllocated(numVoices); }
+    void add(SynthVoice* voice);
+    // 鳴り終わったボイスを一覧から外す (描画の後に呼ぶ)
+    void removeInactive();
+
+    bool isEmpty() const noexcept { return voices.isEmpty(); }
+    int size() const noexcept { return voices.size(); }
+    int getNumActive() const noexcept { return numActive.load(std::memory_order_relaxed); }
+
+    void clear() { voices.clearQuick(); numActive.store(0, std::memory_order_relaxed); }
+
+    SynthVoice** begin() noexcept { return voices.begin(); }
+    SynthVoice** end() noexcept { return voices.end(); }
+    SynthVoice* const* begin() const noexcept { return voices.begin(); }
+    SynthVoice* const* end() const noexcept { return voices.end(); }
+private:
+    juce::Array<SynthVoice*> voices;
+    std::atomic<int> numActive{ 0 };
+};
+
 class SynthVoice : public juce::SynthesiserVoice
 {
 public:
@@ -35,6 +62,13 @@ public:
     void prepare(double sampleRate);
     void setParameters(const SynthParams& params);
 
+    // プロセッサが保持する最新パラメータとそのバージョンを登録する
+    void setParameterSource(const SynthParams* params, const uint32_t* version);
+    // バージョンが変わっている時だけ、アクティブなコアへパラメータを反映する
+    void syncParameters();
+    // 発音開始時に自分を登録する一覧 (nullptr なら登録しない)
+    void setActiveList(ActiveVoiceList* list) { m_activeList = list; }
+
     AdpcmCore* getAdpcmCore() { return &m_adpcmCore; }
     RhythmCore* getRhythmCore() { return &m_rhythmCore; }
 
@@ -73,15 +107,29 @@ public:
 
     bool isPlaying();
 
+    // 直近のブロックでこのボイスが出力に足した大きさ (ボイススチールの優先度用)
+    float getLevel() const noexcept { return m_level; }
+
     std::map<OscMode, SynthCore *> coreMap;
 
     // ユニゾン・ハーモニー用
     void setUnisonParams(int index, int total, float detune, float spread) 
     {
-        coreMap[m_mode]->setUnisonParams(index, total, detune, spread);
+        // 停止中のボイスはパラメータ未反映の可能性があるので、先にモードを確定させる
+        syncParameters();
+        m_activeCore->setUnisonParams(index, total, detune, spread);
     }
 private:
     OscMode m_mode = OscMode::OPNA;
+    SynthCore* m_activeCore = nullptr; // coreMap[m_mode] のキャッシュ (モード変更時のみ更新)
+    const SynthParams* m_paramSource = nullptr;
+    const uint32_t* m_paramSourceVersion = nullptr;
+    uint32_t m_appliedParamVersion = 0;
+    ActiveVoiceList* m_activeList = nullptr;
+    float m_level = 0.0f;
+
+    // レベル測定に使うサンプル点の最大数 (ブロック全体をまばらに覗く)
+    static constexpr int levelProbes = 32;
     OpnaCore m_opnaCore;
     OpnCore m_opnCore;
     OplCore m_oplCore;
@@ -0,0 +1,143 @@
+﻿#include <thread>
+
+#include "./VoiceRenderPool.h"
+#include "./SynthVoice.h"
+
+VoiceRenderPool::Worker::Worker(VoiceRenderPool& pool, int index)
+    : juce::Thread("VoiceRender" + juce::String(index + 1)), m_pool(pool)
+{
+}
+
+VoiceRenderPool::Worker::~Worker()
+{
+    // release が threadShouldExit を立てて m_wakeCount で起こしてから破棄する
+    stopThread(stopTimeoutMs);
+}
+
+void VoiceRenderPool::Worker::run()
+{
+    juce::uint32 seenWake = m_pool.m_wakeCount.load(std::memory_order_acquire);
+
+    while (!threadShouldExit()) {
+        // 呼び出し元が m_wakeCount を進めて notify するまで眠る (描画中に進んでいれば待たずに戻る)
+        m_pool.m_wakeCount.wait(seenWake, std::memory_order_acquire);
+        if (threadShouldExit()) break;
+
+        seenWake = m_pool.m_wakeCount.load(std::memory_order_acquire);
+        m_pool.runJobs(*this, m_pool.getPublishedGeneration());
+    }
+}
+
+VoiceRenderPool::~VoiceRenderPool()
+{
+    release();
+}
+
+void VoiceRenderPool::prepare(int numWorkers, int maxBlockSize, double sampleRate)
+{
+    release();
+
+    if (numWorkers <= 0 || maxBlockSize <= 0) return;
+
+    m_maxBlockSize = maxBlockSize;
+    m_workers.reserve((size_t)numWorkers);
+
+    const auto options = juce::Thread::RealtimeOptions{}.withApproximateAudioProcessingTime(maxBlockSize, sampleRate);
+
+    for (int i = 0; i < numWorkers; ++i) {
+        auto worker = std::make_unique<Worker>(*this, i);
+        worker->scratch.setSize(2, maxBlockSize);
+
+        // 実時間優先度を得られない環境 (権限の無い Linux 等) では最高の通常優先度で動かす
+        if (!worker->startRealtimeThread(options)) {
+            worker->startThread(juce::Thread::Priority::highest);
+        }
+
+        m_workers.push_back(std::move(worker));
+    }
+}
+
+void VoiceRenderPool::release()
+{
+    // 眠っている作業スレッドを起こして終了させ、Worker のデストラクタで止まるのを待つ
+    for (auto& worker : m_workers) {
+        worker->signalThreadShouldExit();
+    }
+    m_wakeCount.fetch_add(1, std::memory_order_release);
+    m_wakeCount.notify_all();
+
+    m_workers.clear();
+    m_maxBlockSize = 0;
+}
+
+bool VoiceRenderPool::render(SynthVoice* const* voices, int numVoices, juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (m_workers.empty() || numVoices < minParallelVoices || numVoices > maxJobs) return false;
+    if (numSamples < minParallelSamples) return false;
+    if (startSample + numSamples > m_maxBlockSize || buffer.getNumChannels() < 2) return false;
+
+    const juce::uint32 generation = ++m_generation;
+
+    m_jobVoices = voices;
+    m_jobStartSample = startSample;
+    m_jobNumSamples = numSamples;
+    m_jobsDone.store(0, std::memory_order_relaxed);
+    m_cursor.store(makeCursor(generation, numVoices), std::memory_order_release);
+    // 眠っている作業スレッドを起こす (ロックは取らず、待っているスレッドがいる時だけシステムコールになる)
+    m_wakeCount.fetch_add(1, std::memory_order_release);
+    m_wakeCount.notify_all();
+
+    // 呼び出し元も働き、出力バッファへ直接描画する (作業スレッドが起きる前のジョブもここで引き取る)
+    for (int job = claimJob(generation); job >= 0; job = claimJob(generation)) {
+        voices[job]->renderNextBlock(buffer, startSample, numSamples);
+        m_jobsDone.fetch_add(1, std::memory_order_release);
+    }
+
+    // 残りは作業スレッドが描画中のジョブなので、待ちは通常ボイス 1 つ分 (作業スレッドの優先度はヘッダを参照)
+    while (m_jobsDone.load(std::memory_order_acquire) < numVoices) {
+        std::this_thread::yield();
+    }
+
+    for (auto& worker : m_workers) {
+        if (worker->usedGeneration != generation) continue;
+
+        for (int ch = 0; ch < 2; ++ch) {
+            juce::FloatVectorOperations::add(buffer.getWritePointer(ch, startSample), worker->scratch.getReadPointer(ch, startSample), numSamples);
+        }
+    }
+
+    return true;
+}
+
+int VoiceRenderPool::claimJob(juce::uint32 generation) noexcept
+{
+    juce::uint64 cursor = m_cursor.load(std::memory_order_acquire);
+
+    while (true) {
+        if ((juce::uint32)(cursor >> 32) != generation) return -1;
+
+        const int numJobs = (int)((cursor >> 16) & 0xFFFF);
+        const int next = (int)(cursor & 0xFFFF);
+        if (next >= numJobs) return -1;
+
+        if (m_cursor.compare_exchange_weak(cursor, cursor + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return next;
+        }
+    }
+}
+
+void VoiceRenderPool::runJobs(Worker& worker, juce::uint32 generation) noexcept
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    for (int job = claimJob(generation); job >= 0; job = claimJob(generation)) {
+        // ジョブを取れた世代の間は、ジョブの内容は書き換えられない
+        if (worker.usedGeneration != generation) {
+            worker.scratch.clear(m_jobStartSample, m_jobNumSamples);
+            worker.usedGeneration = generation;
+        }
+
+        m_jobVoices[job]->renderNextBlock(worker.scratch, m_jobStartSample, m_jobNumSamples);
+        m_jobsDone.fetch_add(1, std::memory_order_release);
+    }
+}
@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class SynthVoice;
+
+// 発音中のボイスを作業スレッドと呼び出し元 (オーディオスレッド) で分担して描画する
+// ジョブの取り合いは 1 つのアトミック変数で行い、描画中にロックもメモリ確保もしない
+// 作業スレッドは実時間優先度で動き、ジョブが無い間はアトミック変数の wait (futex 等) で眠る
+// 呼び出し元はジョブを公開したら notify で起こすだけで、ロックは取らない
+// (起きるのが遅れても、まだ取られていないジョブは呼び出し元が描画するので待たされない)
+// 作業スレッドはそれぞれ専用のスクラッチバッファへ描画し、最後に呼び出し元が足し込む
+//
+// 作業スレッドが取ったジョブは描画途中で引き取れないので、呼び出し元はその描画が終わるまで待つ
+// 作業スレッドをオーディオスレッドと同じ実時間優先度にして、その間に横取りされにくくしている
+// (実時間優先度を得られない環境では highest で動くので、その場合は既定の無効のまま使うこと)
+class VoiceRenderPool
+{
+public:
+    VoiceRenderPool() = default;
+    ~VoiceRenderPool();
+
+    // 作業スレッドを作り直し、スクラッチを確保する (numWorkers が 0 なら無効)
+    // 作業スレッドの実時間優先度はブロック長とサンプルレートから見積もった処理時間で要求する
+    // オーディオスレッドが render を呼んでいない時 (prepareToPlay / 処理の一時停止中) に呼ぶこと
+    void prepare(int numWorkers, int maxBlockSize, double sampleRate);
+    void release();
+
+    int getNumWorkers() const noexcept { return (int)m_workers.size(); }
+
+    // voices を分担して描画し buffer へ足し込む
+    // 分担しない (作業スレッドが無い・ボイスが少ない・ブロックがスクラッチより長い) 時は false を返すので、呼び出し元で直列に描画する
+    bool render(SynthVoice* const* voices, int numVoices, juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+private:
+    class Worker final : public juce::Thread
+    {
+    public:
+        Worker(VoiceRenderPool& pool, int index);
+        ~Worker() override;
+
+        void run() override;
+
+        juce::AudioBuffer<float> scratch;
+        juce::uint32 usedGeneration = 0; // このスクラッチへ最後に描画した世代 (ジョブ完了の通知で公開される)
+    private:
+        VoiceRenderPool& m_pool;
+    };
+
+    static constexpr int minParallelVoices = 4;    // これより少なければ起こす手間の方が大きいので分担しない
+    static constexpr int minParallelSamples = 32;  // MIDI イベントで細かく分割された区間も同様
+    static constexpr int maxJobs = 0xFFFF;         // カーソルの 1 フィールドに収まるジョブ数
+    static constexpr int stopTimeoutMs = 2000;
+
+    // カーソル: 上位 32bit が世代、続く 16bit がジョブ数、下位 16bit が次に取るジョブの番号
+    static constexpr juce::uint64 makeCursor(juce::uint32 generation, int numJobs) noexcept {
+        return ((juce::uint64)generation << 32) | ((juce::uint64)numJobs << 16);
+    }
+
+    // 指定の世代のジョブを 1 つ取る (取れなければ -1)
+    int claimJob(juce::uint32 generation) noexcept;
+    // 公開中のジョブの世代
+    juce::uint32 getPublishedGeneration() const noexcept { return (juce::uint32)(m_cursor.load(std::memory_order_acquire) >> 32); }
+    // 指定の世代のジョブが無くなるまで描画する (作業スレッドから呼ぶ)
+    void runJobs(Worker& worker, juce::uint32 generation) noexcept;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    int m_maxBlockSize = 0;
+
+    // 現在のブロックのジョブ (カーソルの公開より前に書き、世代のジョブが全て終わるまで書き換えない)
+    SynthVoice* const* m_jobVoices = nullptr;
+    int m_jobStartSample = 0;
+    int m_jobNumSamples = 0;
+
+    std::atomic<juce::uint64> m_cursor{ 0 };
+    std::atomic<int> m_jobsDone{ 0 };
+    // 作業スレッドを起こす度に進める (作業スレッドはこの値の wait で眠る。停止時にも進めて起こす)
+    std::atomic<juce::uint32> m_wakeCount{ 0 };
+    juce::uint32 m_generation = 0; // オーディオスレッドのみが進める
+};
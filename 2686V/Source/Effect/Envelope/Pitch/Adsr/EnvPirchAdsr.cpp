@@ -2,6 +2,7 @@
 #include <cmath>
 
 #include "./EnvPirchAdsr.h"
+#include "../../../../Core/Synth/SynthFastMath.h"
 
 PitchAdsrEnv::PitchAdsrEnv() {
 }
@@ -107,7 +108,7 @@ float PitchAdsrEnv::process(float phaseDelta) {
             if (this->currentCents != 0.0f) {
                 // 1200セント = 1オクターブ (2倍の周波数)
                 // 例: +1200 なら 2.0, -1200 なら 0.5, 0 なら 1.0 になる
-                pitchRatio = std::pow(2.0f, this->currentCents / 1200.0f);
+                pitchRatio = FastMath::centsToRatio(this->currentCents);
                 phaseDelta *= pitchRatio;
             }
 
@@ -136,7 +137,7 @@ float PitchAdsrEnv::process(float phaseDelta) {
             if (this->currentCents != 0.0f) {
                 // 1200セント = 1オクターブ (2倍の周波数)
                 // 例: +1200 なら 2.0, -1200 なら 0.5, 0 なら 1.0 になる
-                pitchRatio = std::pow(2.0f, this->currentCents / 1200.0f);
+                pitchRatio = FastMath::centsToRatio(this->currentCents);
                 phaseDelta *= pitchRatio;
             }
 
@@ -148,7 +149,7 @@ float PitchAdsrEnv::process(float phaseDelta) {
             if (this->currentCents != 0.0f) {
                 // 1200セント = 1オクターブ (2倍の周波数)
                 // 例: +1200 なら 2.0, -1200 なら 0.5, 0 なら 1.0 になる
-                pitchRatio = std::pow(2.0f, this->currentCents / 1200.0f);
+                pitchRatio = FastMath::centsToRatio(this->currentCents);
                 phaseDelta *= pitchRatio;
             }
 
@@ -170,7 +171,7 @@ float PitchAdsrEnv::process(float phaseDelta) {
             if (this->currentCents != 0.0f) {
                 // 1200セント = 1オクターブ (2倍の周波数)
                 // 例: +1200 なら 2.0, -1200 なら 0.5, 0 なら 1.0 になる
-                pitchRatio = std::pow(2.0f, this->currentCents / 1200.0f);
+                pitchRatio = FastMath::centsToRatio(this->currentCents);
                 phaseDelta *= pitchRatio;
             }
 
@@ -205,7 +206,7 @@ float PitchAdsrEnv::process(float phaseDelta) {
             if (this->currentCents != 0.0f) {
                 // 1200セント = 1オクターブ (2倍の周波数)
                 // 例: +1200 なら 2.0, -1200 なら 0.5, 0 なら 1.0 になる
-                pitchRatio = std::pow(2.0f, this->currentCents / 1200.0f);
+                pitchRatio = FastMath::centsToRatio(this->currentCents);
                 phaseDelta *= pitchRatio;
             }
 
@@ -241,7 +242,7 @@ float PitchAdsrEnv::process(float phaseDelta) {
             if (this->currentCents != 0.0f) {
                 // 1200セント = 1オクターブ (2倍の周波数)
                 // 例: +1200 なら 2.0, -1200 なら 0.5, 0 なら 1.0 になる
-                pitchRatio = std::pow(2.0f, this->currentCents / 1200.0f);
+                pitchRatio = FastMath::centsToRatio(this->currentCents);
                 phaseDelta *= pitchRatio;
             }
 
@@ -253,7 +254,7 @@ float PitchAdsrEnv::process(float phaseDelta) {
             if (this->currentCents != 0.0f) {
                 // 1200セント = 1オクターブ (2倍の周波数)
                 // 例: +1200 なら 2.0, -1200 なら 0.5, 0 なら 1.0 になる
-                pitchRatio = std::pow(2.0f, this->currentCents / 1200.0f);
+                pitchRatio = FastMath::centsToRatio(this->currentCents);
                 phaseDelta *= pitchRatio;
             }
 
@@ -282,7 +283,7 @@ float PitchAdsrEnv::process(float phaseDelta) {
             if (this->currentCents != 0.0f) {
                 // 1200セント = 1オクターブ (2倍の周波数)
                 // 例: +1200 なら 2.0, -1200 なら 0.5, 0 なら 1.0 になる
-                pitchRatio = std::pow(2.0f, this->currentCents / 1200.0f);
+                pitchRatio = FastMath::centsToRatio(this->currentCents);
                 phaseDelta *= pitchRatio;
             }
 
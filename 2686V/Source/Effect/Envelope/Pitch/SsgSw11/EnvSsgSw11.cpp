@@ -1,6 +1,7 @@
 ﻿#include <algorithm>
 
 #include "./EnvSsgSw11.h"
+#include "../../../../Core/Synth/SynthFastMath.h"
 
 SsgSwPEnv11::SsgSwPEnv11() {
 }
@@ -500,7 +501,7 @@ float SsgSwPEnv11::process(float phaseDelta) {
     // --- セント値を周波数比に変換して phaseDelta に適用 ---
     if (this->currentLevel != 0.0f) {
         // 1200セント = 1オクターブ (2倍の周波数)
-        float pitchRatio = std::pow(2.0f, this->currentLevel / 1200.0f);
+        float pitchRatio = FastMath::centsToRatio(this->currentLevel);
         phaseDelta *= pitchRatio;
     }
 
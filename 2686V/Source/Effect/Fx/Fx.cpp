@@ -1,14 +1,38 @@
 ﻿#include <vector>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include "./Fx.h"
 
 #include "../../Core/Processor/ProcessorKeys.h"
 
+namespace
+{
+    // テールの終端とみなすレベル (-90dB)
+    constexpr double tailSilenceGain = 3.1622776601683795e-5;
+
+    // ループ利得 gain の帰還系が -90dB まで減衰するのに必要な周回数
+    double decayCycles(double gain)
+    {
+        gain = std::abs(gain);
+        if (gain < tailSilenceGain) return 1.0;
+        if (gain >= 1.0) return std::numeric_limits<double>::infinity();
+        return 1.0 + std::ceil(std::log(tailSilenceGain) / std::log(gain));
+    }
+
+    // 共振周波数 freq / Q の 2 次 IIR が -90dB まで減衰する秒数 (包絡線の減衰率は ω0 / 2Q)
+    double resonatorTail(double freq, double q)
+    {
+        return -std::log(tailSilenceGain) * 2.0 * std::max(q, 0.5) / (juce::MathConstants<double>::twoPi * std::max(freq, 1.0));
+    }
+}
+
 void FxTremolo::prepare(double sampleRate)
 {
     fs = sampleRate;
     phase = 0.0;
+    prepareWet(sampleRate);
 }
 
 void FxTremolo::setParameters(float rate, float depth, float mix)
@@ -17,12 +41,12 @@ void FxTremolo::setParameters(float rate, float depth, float mix)
     freq = rate;
     // depth: 0.0 - 1.0
     dep = depth;
-    wetLevel = mix;
+    setWetLevel(mix);
 }
 
 void FxTremolo::process(juce::AudioBuffer<float>& buffer)
 {
-    if (wetLevel < 0.01f) return;
+    if (isWetSilent()) return;
 
     const int numSamples = buffer.getNumSamples();
     const int numChannels = buffer.getNumChannels();
@@ -38,6 +62,7 @@ void FxTremolo::process(juce::AudioBuffer<float>& buffer)
         // Depth=0 -> Gain=1
         // Depth=1 -> Gain=0~1 (Oscillate)
         float gain = (1.0f - dep) + (dep * lfo);
+        const float mix = wetSmoother.getNextValue();
 
         // Update phase
         phase += phaseInc;
@@ -48,7 +73,7 @@ void FxTremolo::process(juce::AudioBuffer<float>& buffer)
             float* data = buffer.getWritePointer(ch);
             float dry = data[i];
             float wet = dry * gain;
-            data[i] = (dry * (1.0f - wetLevel)) + (wet * wetLevel);
+            data[i] = (dry * (1.0f - mix)) + (wet * mix);
         }
     }
 }
@@ -62,13 +87,14 @@ void FxVibrato::prepare(double sampleRate)
     delayBuffer.clear();
     writePos = 0;
     phase = 0.0;
+    prepareWet(sampleRate);
 }
 
 void FxVibrato::setParameters(float rate, float depth, float mix)
 {
     freq = rate;
     dep = depth; // 0.0 - 1.0
-    wetLevel = mix;
+    setWetLevel(mix);
 }
 
 void FxVibrato::process(juce::AudioBuffer<float>& buffer)
@@ -94,6 +120,7 @@ void FxVibrato::process(juce::AudioBuffer<float>& buffer)
         auto* dData = delayBuffer.getWritePointer(ch);
         int currentWritePos = startWritePos;
         double currentPhase = phase;
+        auto mixSmoother = wetSmoother; // 各チャンネルで同じ Mix の軌跡をたどる
 
         for (int i = 0; i < numSamples; ++i) {
             float dry = chData[i];
@@ -121,8 +148,9 @@ void FxVibrato::process(juce::AudioBuffer<float>& buffer)
             float wet = dData[indexA] * (1.0f - frac) + dData[indexB] * frac;
 
             // Output
-            if (wetLevel > 0.0f) {
-                chData[i] = (dry * (1.0f - wetLevel)) + (wet * wetLevel);
+            const float mix = mixSmoother.getNextValue();
+            if (mix > 0.0f) {
+                chData[i] = (dry * (1.0f - mix)) + (wet * mix);
             }
 
             // Increment
@@ -142,6 +170,8 @@ void FxVibrato::process(juce::AudioBuffer<float>& buffer)
     phase += phaseInc * numSamples;
     while (phase >= juce::MathConstants<double>::twoPi)
         phase -= juce::MathConstants<double>::twoPi;
+
+    wetSmoother.skip(numSamples);
 }
 
 void FxVibrato::clear()
@@ -151,6 +181,12 @@ void FxVibrato::clear()
     phase = 0.0;
 }
 
+double FxVibrato::getTailSeconds() const
+{
+    // 常に処理されるので、ディレイバッファ 1 周分が残響になる
+    return (double)delayBuffer.getNumSamples() / fs;
+}
+
 void FxMBC::prepare(double sampleRate)
 {
     // 状態のリセット
@@ -158,6 +194,7 @@ void FxMBC::prepare(double sampleRate)
         counter[i] = 0;
         heldSample[i] = 0.0f;
     }
+    prepareWet(sampleRate);
 }
 
 void FxMBC::setParameters(float rateReduction, float bitDepth, float mix)
@@ -169,12 +206,12 @@ void FxMBC::setParameters(float rateReduction, float bitDepth, float mix)
     // 量子化ステップ数を計算 (例: 4bit -> 16段階)
     quantizeStep = std::pow(2.0f, bitDepth);
 
-    wetLevel = mix;
+    setWetLevel(mix);
 }
 
 void FxMBC::process(juce::AudioBuffer<float>& buffer)
 {
-    if (wetLevel < 0.01f && stepSize == 1) return;
+    if (isWetSilent() && stepSize == 1) return;
 
     int numSamples = buffer.getNumSamples();
     int numChannels = buffer.getNumChannels();
@@ -186,6 +223,7 @@ void FxMBC::process(juce::AudioBuffer<float>& buffer)
         // チャンネルごとの状態維持
         int& cnt = counter[ch];
         float& hold = heldSample[ch];
+        auto mixSmoother = wetSmoother;
 
         for (int i = 0; i < numSamples; ++i)
         {
@@ -211,9 +249,12 @@ void FxMBC::process(juce::AudioBuffer<float>& buffer)
             }
 
             // Mix (Dry/Wet)
-            data[i] = (dry * (1.0f - wetLevel)) + (processed * wetLevel);
+            const float mix = mixSmoother.getNextValue();
+            data[i] = (dry * (1.0f - mix)) + (processed * mix);
         }
     }
+
+    wetSmoother.skip(numSamples);
 }
 
 void FxMBC::clear()
@@ -231,6 +272,7 @@ void FxDelay::prepare(double sampleRate)
     delayBuffer.setSize(2, maxSamples);
     delayBuffer.clear();
     writePos = 0;
+    prepareWet(sampleRate);
 }
 
 void FxDelay::setParameters(float timeMs, float feedback, float mix)
@@ -238,12 +280,12 @@ void FxDelay::setParameters(float timeMs, float feedback, float mix)
     // Smooth parameter changes could be added here
     delayTimeSamples = std::max(1, (int)(fs * timeMs / 1000.0));
     fb = juce::jlimit(0.0f, 0.95f, feedback);
-    wetLevel = juce::jlimit(0.0f, 1.0f, mix);
+    setWetLevel(juce::jlimit(0.0f, 1.0f, mix));
 }
 
 void FxDelay::process(juce::AudioBuffer<float>& buffer)
 {
-    if (wetLevel < 0.01f) return; // Skip if mix is 0
+    if (isWetSilent()) return; // Skip if mix is 0
 
     const int numSamples = buffer.getNumSamples();
     const int delayBufLen = delayBuffer.getNumSamples();
@@ -258,6 +300,7 @@ void FxDelay::process(juce::AudioBuffer<float>& buffer)
         // チャンネルごとのループでは、一時的な位置変数を使う
         // これにより、Lchの処理が終わってもRchは正しい位置からスタートできる
         int currentWritePos = startWritePos;
+        auto mixSmoother = wetSmoother;
 
         for (int i = 0; i < numSamples; ++i)
         {
@@ -283,7 +326,8 @@ void FxDelay::process(juce::AudioBuffer<float>& buffer)
             delayData[currentWritePos] = nextVal;
 
             // ミックスして出力
-            channelData[i] = (dry * (1.0f - wetLevel)) + (wet * wetLevel);
+            const float mix = mixSmoother.getNextValue();
+            channelData[i] = (dry * (1.0f - mix)) + (wet * mix);
 
             // 一時ポインタを進める
             currentWritePos++;
@@ -294,6 +338,7 @@ void FxDelay::process(juce::AudioBuffer<float>& buffer)
     // 全チャンネルの処理が終わってから、メインの書き込み位置を更新する
     writePos += numSamples;
     while (writePos >= delayBufLen) writePos -= delayBufLen;
+    wetSmoother.skip(numSamples);
 }
 
 void FxDelay::clear()
@@ -302,8 +347,16 @@ void FxDelay::clear()
     writePos = 0;
 }
 
+double FxDelay::getTailSeconds() const
+{
+    if (wetLevel < 0.01f) return 0.0; // process() で素通しされる
+
+    return (double)delayTimeSamples / fs * decayCycles(fb);
+}
+
 void FxReverb::prepare(double sampleRate)
 {
+    fs = sampleRate;
     reverb.setSampleRate(sampleRate);
 }
 
@@ -330,6 +383,21 @@ void FxReverb::clear()
     reverb.reset();
 }
 
+double FxReverb::getTailSeconds() const
+{
+    const auto p = reverb.getParameters();
+    if (p.wetLevel <= 0.0f) return 0.0;
+    if (p.freezeMode >= 0.5f) return std::numeric_limits<double>::infinity();
+
+    // juce::Reverb (Freeverb) の最長コム (1617 + ステレオ拡散 23 サンプル @44.1kHz) とオールパス 4 段で見積もる
+    // コムの帰還量は roomSize * 0.28 + 0.7、ダンピングは考慮しない (長めに見積もる)
+    constexpr double combSeconds = (1617.0 + 23.0) / 44100.0;
+    constexpr double allPassSeconds = (556.0 + 441.0 + 341.0 + 225.0) / 44100.0;
+    const double feedback = p.roomSize * 0.28 + 0.7;
+
+    return combSeconds * decayCycles(feedback) + allPassSeconds;
+}
+
 // --- Filter ---
 void FxFilter::prepare(double sampleRate)
 {
@@ -342,6 +410,12 @@ void FxFilter::prepare(double sampleRate)
     filterR.prepare(spec);
     filterL.reset();
     filterR.reset();
+
+    freqSmoother.reset(sampleRate, wetRampSeconds);
+    freqSmoother.setCurrentAndTargetValue(currentFreq);
+    qSmoother.reset(sampleRate, wetRampSeconds);
+    qSmoother.setCurrentAndTargetValue(currentQ);
+    prepareWet(sampleRate);
 }
 
 void FxFilter::setParameters(float type, float freq, float q, float mix)
@@ -349,7 +423,7 @@ void FxFilter::setParameters(float type, float freq, float q, float mix)
     currentType = (int)type;
     currentFreq = freq;
     currentQ = q;
-    wetLevel = mix;
+    setWetLevel(mix);
 
     using FType = juce::dsp::StateVariableTPTFilterType;
     FType fType = FType::lowpass;
@@ -358,15 +432,21 @@ void FxFilter::setParameters(float type, float freq, float q, float mix)
 
     filterL.setType(fType);
     filterR.setType(fType);
-    filterL.setCutoffFrequency(currentFreq);
-    filterR.setCutoffFrequency(currentFreq);
-    filterL.setResonance(currentQ);
-    filterR.setResonance(currentQ);
+
+    // カットオフ / Q は process() 内で補間しながら反映する
+    freqSmoother.setTargetValue(currentFreq);
+    qSmoother.setTargetValue(currentQ);
+    if (!freqSmoother.isSmoothing() && !qSmoother.isSmoothing()) {
+        filterL.setCutoffFrequency(currentFreq);
+        filterR.setCutoffFrequency(currentFreq);
+        filterL.setResonance(currentQ);
+        filterR.setResonance(currentQ);
+    }
 }
 
 void FxFilter::process(juce::AudioBuffer<float>& buffer)
 {
-    if (wetLevel < 0.01f) return;
+    if (isWetSilent()) return;
 
     int numSamples = buffer.getNumSamples();
     float* outL = buffer.getWritePointer(0);
@@ -374,14 +454,26 @@ void FxFilter::process(juce::AudioBuffer<float>& buffer)
 
     for (int i = 0; i < numSamples; ++i)
     {
+        // 係数の再計算 (tan) は補間中のサンプルだけで行う
+        if (freqSmoother.isSmoothing() || qSmoother.isSmoothing()) {
+            const float f = freqSmoother.getNextValue();
+            const float q = qSmoother.getNextValue();
+            filterL.setCutoffFrequency(f);
+            filterR.setCutoffFrequency(f);
+            filterL.setResonance(q);
+            filterR.setResonance(q);
+        }
+
+        const float mix = wetSmoother.getNextValue();
+
         float dryL = outL[i];
         float wetL = filterL.processSample(0, dryL);
-        outL[i] = (dryL * (1.0f - wetLevel)) + (wetL * wetLevel);
+        outL[i] = (dryL * (1.0f - mix)) + (wetL * mix);
 
         if (buffer.getNumChannels() > 1) {
             float dryR = outR[i];
             float wetR = filterR.processSample(0, dryR);
-            outR[i] = (dryR * (1.0f - wetLevel)) + (wetR * wetLevel);
+            outR[i] = (dryR * (1.0f - mix)) + (wetR * mix);
         }
     }
 }
@@ -393,49 +485,94 @@ void FxFilter::clear()
     filterR.reset();
 }
 
+double FxFilter::getTailSeconds() const
+{
+    if (wetLevel < 0.01f) return 0.0;
+
+    return resonatorTail(currentFreq, currentQ);
+}
+
 void FxEq3b::prepare(double sampleRate)
 {
     fs = sampleRate;
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = 4096;
-    spec.numChannels = 1;
-
-    lowShelfL.prepare(spec); lowShelfR.prepare(spec);
-    midBellL.prepare(spec);  midBellR.prepare(spec);
-    highShelfL.prepare(spec); highShelfR.prepare(spec);
+    // サンプルレートが変わったので、次の setParameters で係数を作り直して即適用する
+    needsSnap = true;
+    prepareWet(sampleRate);
 
     clear();
 }
 
 void FxEq3b::setParameters(float lowGainDb, float midFreq, float midGainDb, float highGainDb, float mix)
 {
+    // 毎ブロック呼ばれるので、値が変わった時だけ係数を計算する
+    if (needsSnap ||
+        lowGainDb != lastLowGainDb || midFreq != lastMidFreq ||
+        midGainDb != lastMidGainDb || highGainDb != lastHighGainDb) {
+        updateCoefficients(lowGainDb, midFreq, midGainDb, highGainDb);
+    }
+
+    setWetLevel(mix); // EQの場合、Mixは全体のDry/Wetバランスとして使用
+}
+
+void FxEq3b::updateCoefficients(float lowGainDb, float midFreq, float midGainDb, float highGainDb)
+{
+    lastLowGainDb = lowGainDb;
+    lastMidFreq = midFreq;
+    lastMidGainDb = midGainDb;
+    lastHighGainDb = highGainDb;
+
     // Q値（帯域幅）は固定値（0.707 など）にしておくとシンプルです
     float q = 0.707f;
     float midQ = 1.0f; // Midは少し狭めにすると使いやすい
 
     // Low Shelf (固定周波数 例: 200Hz)
-    auto lowCoefs = juce::dsp::IIR::Coefficients<float>::makeLowShelf(fs, 200.0f, q, juce::Decibels::decibelsToGain(lowGainDb));
-    lowShelfL.coefficients = lowCoefs;
-    lowShelfR.coefficients = lowCoefs;
+    target[Low] = makeLowShelf(fs, 200.0f, q, juce::Decibels::decibelsToGain(lowGainDb));
 
     // Mid Bell (可変周波数)
-    auto midCoefs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(fs, midFreq, midQ, juce::Decibels::decibelsToGain(midGainDb));
-    midBellL.coefficients = midCoefs;
-    midBellR.coefficients = midCoefs;
+    target[Mid] = makePeakFilter(fs, midFreq, midQ, juce::Decibels::decibelsToGain(midGainDb));
 
     // High Shelf (固定周波数 例: 5000Hz)
-    auto highCoefs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(fs, 5000.0f, q, juce::Decibels::decibelsToGain(highGainDb));
-    highShelfL.coefficients = highCoefs;
-    highShelfR.coefficients = highCoefs;
+    target[High] = makeHighShelf(fs, 5000.0f, q, juce::Decibels::decibelsToGain(highGainDb));
 
-    wetLevel = mix; // EQの場合、Mixは全体のDry/Wetバランスとして使用
+    if (needsSnap) {
+        current = target;
+        rampRemaining = 0;
+        needsSnap = false;
+        return;
+    }
+
+    // 現在の係数から目標の係数へ、coefRampSamples かけて直線補間する
+    const float inv = 1.0f / (float)coefRampSamples;
+    for (int band = 0; band < Bands; ++band) {
+        step[band].b0 = (target[band].b0 - current[band].b0) * inv;
+        step[band].b1 = (target[band].b1 - current[band].b1) * inv;
+        step[band].b2 = (target[band].b2 - current[band].b2) * inv;
+        step[band].a1 = (target[band].a1 - current[band].a1) * inv;
+        step[band].a2 = (target[band].a2 - current[band].a2) * inv;
+    }
+    rampRemaining = coefRampSamples;
+}
+
+void FxEq3b::advanceRamp() noexcept
+{
+    if (--rampRemaining <= 0) {
+        current = target; // 誤差を残さないよう最後は目標値に揃える
+        return;
+    }
+
+    for (int band = 0; band < Bands; ++band) {
+        current[band].b0 += step[band].b0;
+        current[band].b1 += step[band].b1;
+        current[band].b2 += step[band].b2;
+        current[band].a1 += step[band].a1;
+        current[band].a2 += step[band].a2;
+    }
 }
 
 void FxEq3b::process(juce::AudioBuffer<float>& buffer)
 {
-    if (wetLevel < 0.01f) return;
+    if (isWetSilent()) return;
 
     int numSamples = buffer.getNumSamples();
     float* outL = buffer.getWritePointer(0);
@@ -443,35 +580,112 @@ void FxEq3b::process(juce::AudioBuffer<float>& buffer)
 
     for (int i = 0; i < numSamples; ++i)
     {
+        if (rampRemaining > 0) advanceRamp();
+
         float dryL = outL[i];
         float dryR = outR[i];
 
         // L channel: Low -> Mid -> High と直列に処理
-        float wetL = lowShelfL.processSample(dryL);
-        wetL = midBellL.processSample(wetL);
-        wetL = highShelfL.processSample(wetL);
+        float wetL = processBiquad(current[Low], stateL[Low], dryL);
+        wetL = processBiquad(current[Mid], stateL[Mid], wetL);
+        wetL = processBiquad(current[High], stateL[High], wetL);
 
         // R channel
         float wetR = dryR;
         if (buffer.getNumChannels() > 1) {
-            wetR = lowShelfR.processSample(dryR);
-            wetR = midBellR.processSample(wetR);
-            wetR = highShelfR.processSample(wetR);
+            wetR = processBiquad(current[Low], stateR[Low], dryR);
+            wetR = processBiquad(current[Mid], stateR[Mid], wetR);
+            wetR = processBiquad(current[High], stateR[High], wetR);
         }
 
         // Mix (Dry/Wet)
-        outL[i] = (dryL * (1.0f - wetLevel)) + (wetL * wetLevel);
+        const float mix = wetSmoother.getNextValue();
+        outL[i] = (dryL * (1.0f - mix)) + (wetL * mix);
         if (buffer.getNumChannels() > 1) {
-            outR[i] = (dryR * (1.0f - wetLevel)) + (wetR * wetLevel);
+            outR[i] = (dryR * (1.0f - mix)) + (wetR * mix);
         }
     }
+
+    // 無音が続いた時にデノーマルが残らないようにする
+    for (int band = 0; band < Bands; ++band) {
+        juce::dsp::util::snapToZero(stateL[band].s1); juce::dsp::util::snapToZero(stateL[band].s2);
+        juce::dsp::util::snapToZero(stateR[band].s1); juce::dsp::util::snapToZero(stateR[band].s2);
+    }
 }
 
 void FxEq3b::clear()
 {
-    lowShelfL.reset(); lowShelfR.reset();
-    midBellL.reset();  midBellR.reset();
-    highShelfL.reset(); highShelfR.reset();
+    stateL.fill({});
+    stateR.fill({});
+}
+
+double FxEq3b::getTailSeconds() const
+{
+    // updateCoefficients() と同じ周波数 / Q で、一番長く鳴る帯域を採る
+    return std::max({ resonatorTail(200.0, 0.707), resonatorTail(lastMidFreq, 1.0), resonatorTail(5000.0, 0.707) })
+        + (double)coefRampSamples / fs;
+}
+
+FxEq3b::Coefs FxEq3b::makeLowShelf(double sampleRate, float freq, float q, float gain)
+{
+    const double A = std::sqrt(std::max(0.0f, gain));
+    const double aminus1 = A - 1.0;
+    const double aplus1 = A + 1.0;
+    const double omega = juce::MathConstants<double>::twoPi * std::clamp((double)freq, 2.0, sampleRate * 0.49) / sampleRate;
+    const double coso = std::cos(omega);
+    const double beta = std::sin(omega) * std::sqrt(A) / q;
+    const double aminus1TimesCoso = aminus1 * coso;
+
+    const double a0 = aplus1 + aminus1TimesCoso + beta;
+
+    return {
+        (float)(A * (aplus1 - aminus1TimesCoso + beta) / a0),
+        (float)(A * 2.0 * (aminus1 - aplus1 * coso) / a0),
+        (float)(A * (aplus1 - aminus1TimesCoso - beta) / a0),
+        (float)(-2.0 * (aminus1 + aplus1 * coso) / a0),
+        (float)((aplus1 + aminus1TimesCoso - beta) / a0)
+    };
+}
+
+FxEq3b::Coefs FxEq3b::makePeakFilter(double sampleRate, float freq, float q, float gain)
+{
+    const double A = std::sqrt(std::max(0.0f, gain));
+    const double omega = juce::MathConstants<double>::twoPi * std::clamp((double)freq, 2.0, sampleRate * 0.49) / sampleRate;
+    const double alpha = std::sin(omega) / (q * 2.0);
+    const double c2 = -2.0 * std::cos(omega);
+    const double alphaTimesA = alpha * A;
+    const double alphaOverA = alpha / A;
+
+    const double a0 = 1.0 + alphaOverA;
+
+    return {
+        (float)((1.0 + alphaTimesA) / a0),
+        (float)(c2 / a0),
+        (float)((1.0 - alphaTimesA) / a0),
+        (float)(c2 / a0),
+        (float)((1.0 - alphaOverA) / a0)
+    };
+}
+
+FxEq3b::Coefs FxEq3b::makeHighShelf(double sampleRate, float freq, float q, float gain)
+{
+    const double A = std::sqrt(std::max(0.0f, gain));
+    const double aminus1 = A - 1.0;
+    const double aplus1 = A + 1.0;
+    const double omega = juce::MathConstants<double>::twoPi * std::clamp((double)freq, 2.0, sampleRate * 0.49) / sampleRate;
+    const double coso = std::cos(omega);
+    const double beta = std::sin(omega) * std::sqrt(A) / q;
+    const double aminus1TimesCoso = aminus1 * coso;
+
+    const double a0 = aplus1 - aminus1TimesCoso + beta;
+
+    return {
+        (float)(A * (aplus1 + aminus1TimesCoso + beta) / a0),
+        (float)(A * -2.0 * (aminus1 + aplus1 * coso) / a0),
+        (float)(A * (aplus1 + aminus1TimesCoso - beta) / a0),
+        (float)(2.0 * (aminus1 - aplus1 * coso) / a0),
+        (float)((aplus1 - aminus1TimesCoso - beta) / a0)
+    };
 }
 
 // ======================================================
@@ -484,6 +698,7 @@ void FxSfcEcho::prepare(double sampleRate)
     delayBuffer.setSize(2, maxSamples);
     delayBuffer.clear();
     writePos = 0;
+    prepareWet(sampleRate);
 }
 
 void FxSfcEcho::setParameters(float timeMs, float feedback, float mix)
@@ -498,7 +713,7 @@ void FxSfcEcho::setParameters(float timeMs, float feedback, float mix, const std
     delayTimeSamples = std::max(1, (int)(fs * timeMs / 1000.0));
 
     fb = juce::jlimit(-0.95f, 0.95f, feedback); // SFCエコーは位相反転のフィードバックも可能
-    wetLevel = juce::jlimit(0.0f, 1.0f, mix);
+    setWetLevel(juce::jlimit(0.0f, 1.0f, mix));
 
     // FIR係数の合計絶対値を計算し、安全なレベルに正規化する
     float sum = 0.0f;
@@ -517,7 +732,7 @@ void FxSfcEcho::setParameters(float timeMs, float feedback, float mix, const std
 
 void FxSfcEcho::process(juce::AudioBuffer<float>& buffer)
 {
-    if (wetLevel < 0.01f) return;
+    if (isWetSilent()) return;
 
     const int numSamples = buffer.getNumSamples();
     const int delayBufLen = delayBuffer.getNumSamples();
@@ -530,6 +745,7 @@ void FxSfcEcho::process(juce::AudioBuffer<float>& buffer)
         auto* delayData = delayBuffer.getWritePointer(ch);
 
         int currentWritePos = startWritePos;
+        auto mixSmoother = wetSmoother;
 
         for (int i = 0; i < numSamples; ++i)
         {
@@ -560,7 +776,8 @@ void FxSfcEcho::process(juce::AudioBuffer<float>& buffer)
             delayData[currentWritePos] = nextVal;
 
             // 3. ミックスして出力
-            channelData[i] = (dry * (1.0f - wetLevel)) + (filteredWet * wetLevel);
+            const float mix = mixSmoother.getNextValue();
+            channelData[i] = (dry * (1.0f - mix)) + (filteredWet * mix);
 
             currentWritePos++;
             if (currentWritePos >= delayBufLen) currentWritePos = 0;
@@ -569,6 +786,7 @@ void FxSfcEcho::process(juce::AudioBuffer<float>& buffer)
 
     writePos += numSamples;
     while (writePos >= delayBufLen) writePos -= delayBufLen;
+    wetSmoother.skip(numSamples);
 }
 
 void FxSfcEcho::clear()
@@ -577,6 +795,14 @@ void FxSfcEcho::clear()
     writePos = 0;
 }
 
+double FxSfcEcho::getTailSeconds() const
+{
+    if (wetLevel < 0.01f) return 0.0;
+
+    // FIR 係数は合計 1.0 以下に正規化されているので、1 周あたりの減衰は |fb| 以下
+    return (double)(delayTimeSamples + 8) / fs * decayCycles(fb);
+}
+
 
 // --- EffectChain への組み込み ---
 EffectChain::EffectChain()
@@ -590,13 +816,47 @@ EffectChain::EffectChain()
     fxMap[static_cast<int>(FxType::Reverb)] = &reverb;
     fxMap[static_cast<int>(FxType::SfcEcho)] = &sfcEcho;
 
-    // 処理順序配列の初期化 (デフォルトは定義順)
-    processChain = fxMap;
+    // 処理順序の初期化 (デフォルトは定義順)
+    std::array<int, NumEffects> defaultOrder;
+    for (int i = 0; i < NumEffects; ++i) defaultOrder[i] = i;
+
+    appliedOrder = packOrder(defaultOrder);
+    publishedOrder.store(appliedOrder);
 }
 
 void EffectChain::prepare(double sampleRate)
 {
     for (auto* fx : fxMap) fx->prepare(sampleRate);
+
+    orderFadeSamples = std::max(1, (int)(sampleRate * orderFadeMs / 1000.0));
+    orderFade = OrderFade::None;
+    orderFadePos = 0;
+    stateCleared = true;
+}
+
+juce::uint32 EffectChain::packOrder(const std::array<int, NumEffects>& order)
+{
+    juce::uint32 packed = 0;
+
+    for (int i = 0; i < NumEffects; ++i)
+    {
+        packed |= (juce::uint32)order[i] << (i * orderBits);
+    }
+
+    return packed;
+}
+
+std::array<int, NumEffects> EffectChain::unpackOrder(juce::uint32 packed)
+{
+    std::array<int, NumEffects> order;
+    constexpr juce::uint32 mask = (1u << orderBits) - 1u;
+
+    for (int i = 0; i < NumEffects; ++i)
+    {
+        order[i] = (int)((packed >> (i * orderBits)) & mask);
+    }
+
+    return order;
 }
 
 // Parameters
@@ -613,13 +873,112 @@ void EffectChain::setSfcEchoParams(float time, float fb, float mix, const std::a
 
 void EffectChain::process(juce::AudioBuffer<float>& buffer)
 {
-    for (auto* fx : processChain)
+    const juce::uint32 order = publishedOrder.load(std::memory_order_acquire);
+
+    // 内部状態が空なら旧順序の残りを鳴らす必要はないので、フェードせずにそのまま取り込む
+    // (停止中に並べ替えた後の最初の発音の頭を削らないため)
+    if (order != appliedOrder && stateCleared)
+    {
+        appliedOrder = order;
+        chainDirty = true;
+        orderFade = OrderFade::None;
+    }
+
+    stateCleared = false;
+
+    if (chainDirty) rebuildActiveChain();
+
+    if (orderFade == OrderFade::None && order == appliedOrder)
     {
+        runChain(buffer);
+        return;
+    }
+
+    // 並べ替え: 旧順序で orderFadeSamples かけてフェードアウトし、順序を差し替えてから同じ長さでフェードインする
+    // (各エフェクトは内部状態を 1 つしか持たないため、2 系統を同時に鳴らすクロスフェードはしない)
+    // フェードの途中経過はブロックをまたいで持ち越すので、ブロックが短くてもランプは短くならない
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = buffer.getNumChannels();
+    const float fadeScale = 1.0f / (float)orderFadeSamples;
+
+    if (orderFade == OrderFade::None)
+    {
+        orderFade = OrderFade::Out;
+        orderFadePos = 0;
+    }
+
+    int pos = 0;
+
+    while (pos < numSamples && orderFade != OrderFade::None)
+    {
+        // フェードイン中にさらに並べ替えられたら、今の音量からフェードアウトに戻る
+        if (orderFade == OrderFade::In && order != appliedOrder)
+        {
+            orderFade = OrderFade::Out;
+            orderFadePos = orderFadeSamples - orderFadePos;
+        }
+
+        const int length = std::min(numSamples - pos, orderFadeSamples - orderFadePos);
+        juce::AudioBuffer<float> part(buffer.getArrayOfWritePointers(), numChannels, pos, length);
+        runChain(part);
+
+        const float startGain = (float)orderFadePos * fadeScale;
+        const float endGain = (float)(orderFadePos + length) * fadeScale;
+
+        if (orderFade == OrderFade::Out) part.applyGainRamp(0, length, 1.0f - startGain, 1.0f - endGain);
+        else                             part.applyGainRamp(0, length, startGain, endGain);
+
+        pos += length;
+        orderFadePos += length;
+
+        if (orderFadePos < orderFadeSamples) break;
+
+        orderFadePos = 0;
+
+        if (orderFade == OrderFade::Out)
+        {
+            // 無音になったところで順序を差し替える
+            appliedOrder = order;
+            rebuildActiveChain();
+            orderFade = OrderFade::In;
+        }
+        else
+        {
+            orderFade = OrderFade::None;
+        }
+    }
+
+    // ブロックの途中でフェードインが終わった残り
+    if (pos < numSamples)
+    {
+        juce::AudioBuffer<float> rest(buffer.getArrayOfWritePointers(), numChannels, pos, numSamples - pos);
+        runChain(rest);
+    }
+}
+
+void EffectChain::rebuildActiveChain()
+{
+    // バイパス中のエフェクトはチェーンから外し、ブロックごとの分岐をなくす
+    activeCount = 0;
+
+    for (int fxId : unpackOrder(appliedOrder))
+    {
+        FxCore* fx = fxMap[fxId];
         if (!fx->isBypass())
         {
-            fx->process(buffer);
+            activeChain[activeCount++] = fx;
         }
     }
+
+    chainDirty = false;
+}
+
+void EffectChain::runChain(juce::AudioBuffer<float>& buffer)
+{
+    for (int i = 0; i < activeCount; ++i)
+    {
+        activeChain[i]->process(buffer);
+    }
 }
 
 // バイパス状態のセット
@@ -633,25 +992,42 @@ void EffectChain::setBypasses(bool fl, bool e3, bool t, bool v, bool mc, bool d,
     delay.setBypass(d);
     reverb.setBypass(r);
     sfcEcho.setBypass(sfc);
+
+    // バイパス状態が変わった時だけ実行列を作り直す
+    juce::uint32 mask = 0;
+    for (int i = 0; i < NumEffects; ++i)
+    {
+        if (fxMap[i]->isBypass()) mask |= 1u << i;
+    }
+
+    if (mask != appliedBypassMask)
+    {
+        appliedBypassMask = mask;
+        chainDirty = true;
+    }
 }
 
 // 順番更新
+// 新しい順序を組み立ててから 1 回の store で公開する (オーディオスレッドは次のブロック境界で取り込む)
 void EffectChain::updateOrder(const std::vector<int>& newOrders)
 {
-    for (int i = 0; i < NumEffects; ++i)
+    std::array<int, NumEffects> orderIndex = unpackOrder(publishedOrder.load(std::memory_order_acquire));
+
+    for (int i = 0; i < NumEffects && i < (int)newOrders.size(); ++i)
     {
         if (newOrders[i] >= 0 && newOrders[i] < NumEffects)
         {
             orderIndex[i] = newOrders[i];
-            processChain[i] = fxMap[newOrders[i]];
         }
     }
+
+    publishedOrder.store(packOrder(orderIndex), std::memory_order_release);
 }
 
 std::vector<int> EffectChain::getOrder() {
     std::vector<int> order;
 
-    for (auto o : orderIndex) {
+    for (auto o : unpackOrder(publishedOrder.load(std::memory_order_acquire))) {
         order.push_back(o);
     }
 
@@ -662,6 +1038,18 @@ int EffectChain::getEffectsNumber() {
     return NumEffects;
 }
 
+double EffectChain::getTailSeconds() const
+{
+    double tail = 0.0;
+
+    for (auto* fx : fxMap)
+    {
+        if (!fx->isBypass()) tail += fx->getTailSeconds();
+    }
+
+    return tail;
+}
+
 // バッファクリア
 void EffectChain::clear()
 {
@@ -669,4 +1057,9 @@ void EffectChain::clear()
     {
         fx->clear();
     }
+
+    // 並べ替えのフェード途中でも、空になったので次のブロックで新しい順序をそのまま取り込む
+    orderFade = OrderFade::None;
+    orderFadePos = 0;
+    stateCleared = true;
 }
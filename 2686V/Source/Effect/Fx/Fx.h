@@ -37,10 +37,29 @@ public:
     virtual void setBypass(bool bp) { bypass = bp; }
     virtual bool isBypass() { return bypass; }
     virtual void clear() {}
+    // 入力が無音になってから出力が -90dB を下回るまでの秒数 (自動バイパス / ホストへのテール報告用)
+    virtual double getTailSeconds() const { return 0.0; }
 protected:
+    // Mix の変化をなめらかにする時間 (パラメータはブロック単位で届くので、サンプル単位で補間する)
+    static constexpr double wetRampSeconds = 0.02;
+
     bool bypass = false; // バイパス管理
-    float wetLevel = 0.0f;
+    float wetLevel = 0.0f; // 目標の Mix (テール計算やスキップ判定に使う)
+    juce::SmoothedValue<float> wetSmoother; // 実際に掛ける Mix
     int order = 1; // エフェクト実行順
+
+    void prepareWet(double sampleRate)
+    {
+        wetSmoother.reset(sampleRate, wetRampSeconds);
+        wetSmoother.setCurrentAndTargetValue(wetLevel);
+    }
+    void setWetLevel(float mix)
+    {
+        wetLevel = mix;
+        wetSmoother.setTargetValue(mix);
+    }
+    // Mix がほぼ 0 で、補間も終わっている (素通しして良い)
+    bool isWetSilent() const noexcept { return wetLevel < 0.01f && !wetSmoother.isSmoothing(); }
 };
 
 // ======================================================
@@ -69,6 +88,7 @@ public:
     void setParameters(float rate, float depth, float mix) override;
     void process(juce::AudioBuffer<float>& buffer) override;
     void clear() override;
+    double getTailSeconds() const override;
 private:
     juce::AudioBuffer<float> delayBuffer;
     double fs = 44100.0;
@@ -107,6 +127,7 @@ public:
     void setParameters(float timeMs, float feedback, float mix) override;
     void process(juce::AudioBuffer<float>& buffer) override;
     void clear() override;
+    double getTailSeconds() const override;
 private:
     juce::AudioBuffer<float> delayBuffer;
     double fs = 44100.0;
@@ -126,8 +147,10 @@ public:
     void setParameters(float size, float damp, float width, float mix);
     void process(juce::AudioBuffer<float>& buffer);
     void clear() override;
+    double getTailSeconds() const override;
 private:
     juce::Reverb reverb;
+    double fs = 44100.0;
 };
 
 // ======================================================
@@ -141,12 +164,17 @@ public:
     void setParameters(float type, float freq, float q, float mix);
     void process(juce::AudioBuffer<float>& buffer) override;
     void clear() override;
+    double getTailSeconds() const override;
 private:
     juce::dsp::StateVariableTPTFilter<float> filterL;
     juce::dsp::StateVariableTPTFilter<float> filterR;
     int currentType = 0;
     float currentFreq = 20000.0f;
     float currentQ = 0.707f;
+
+    // カットオフは対数的に、Q は直線的に補間する (補間中だけサンプルごとに係数を更新)
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> freqSmoother{ 20000.0f };
+    juce::SmoothedValue<float> qSmoother{ 0.707f };
 };
 
 // ======================================================
@@ -162,16 +190,50 @@ public:
 
     void process(juce::AudioBuffer<float>& buffer) override;
     void clear() override;
+    double getTailSeconds() const override;
 
 private:
+    // 双二次フィルタの係数 (a0 で正規化済み)
+    struct Coefs { float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f; };
+    // Transposed Direct Form II の状態
+    struct State { float s1 = 0.0f, s2 = 0.0f; };
+
+    enum Band { Low, Mid, High, Bands };
+
+    // 係数を切り替える時に補間するサンプル数 (ジッパーノイズ防止)
+    static constexpr int coefRampSamples = 64;
+
     double fs = 44100.0;
 
-    // ステレオ用の IIR フィルター (L / R)
-    using IIRFilter = juce::dsp::IIR::Filter<float>;
+    // 係数は値で持ち、パラメータが変わった時だけ計算し直す (ヒープ確保なし)
+    std::array<Coefs, Bands> current; // 補間中の係数
+    std::array<Coefs, Bands> target;  // 目標の係数
+    std::array<Coefs, Bands> step;    // 1サンプルあたりの変化量
+    int rampRemaining = 0;
+    bool needsSnap = true; // 次の係数は補間せずに即適用する
+
+    // ステレオ用のフィルター状態 (L / R)
+    std::array<State, Bands> stateL, stateR;
 
-    IIRFilter lowShelfL, lowShelfR;
-    IIRFilter midBellL, midBellR;
-    IIRFilter highShelfL, highShelfR;
+    // 前回係数を計算した時のパラメータ (変化検出用)
+    float lastLowGainDb = 0.0f;
+    float lastMidFreq = 0.0f;
+    float lastMidGainDb = 0.0f;
+    float lastHighGainDb = 0.0f;
+
+    void updateCoefficients(float lowGainDb, float midFreq, float midGainDb, float highGainDb);
+    void advanceRamp() noexcept;
+    static inline float processBiquad(const Coefs& c, State& st, float in) noexcept {
+        float out = c.b0 * in + st.s1;
+        st.s1 = c.b1 * in - c.a1 * out + st.s2;
+        st.s2 = c.b2 * in - c.a2 * out;
+        return out;
+    }
+
+    // RBJ Audio EQ Cookbook (juce::dsp::IIR::Coefficients と同じ式)
+    static Coefs makeLowShelf(double sampleRate, float freq, float q, float gain);
+    static Coefs makePeakFilter(double sampleRate, float freq, float q, float gain);
+    static Coefs makeHighShelf(double sampleRate, float freq, float q, float gain);
 };
 
 // ======================================================
@@ -191,6 +253,7 @@ public:
 
     void process(juce::AudioBuffer<float>& buffer) override;
     void clear() override;
+    double getTailSeconds() const override;
 private:
     juce::AudioBuffer<float> delayBuffer;
     double fs = 44100.0;
@@ -224,6 +287,8 @@ public:
     std::vector<int> getOrder();
     int getEffectsNumber();
     void clear();
+    // バイパスされていないエフェクトのテールの合計 (直列なので足し合わせる)
+    double getTailSeconds() const;
 private:
     // 各エフェクトオブジェクト
     FxFilter filter;
@@ -235,10 +300,32 @@ private:
     FxReverb reverb;
     FxSfcEcho sfcEcho;
 
-    // エフェクトの適応順
-    std::array<int, NumEffects> orderIndex{ { 0, 1, 2, 3, 4, 5, 6, 7 } };
-    std::vector<FxCore*> fxs{ &filter, &eq3b, &tremolo, &vibrato, &modernBitCrusher, &delay, &reverb, &sfcEcho };
-
     std::array<FxCore*, NumEffects> fxMap;
-    std::array<FxCore*, NumEffects> processChain;
+
+    // エフェクトの適応順 (GUI スレッドが公開する不変スナップショット)
+    // 1 エフェクトあたり 4bit に詰めた値を丸ごと差し替えるので、途中の状態は見えない
+    static constexpr int orderBits = 4;
+    static_assert(NumEffects * orderBits <= 32, "FX order must fit in 32 bits");
+    std::atomic<juce::uint32> publishedOrder{ 0 };
+    static juce::uint32 packOrder(const std::array<int, NumEffects>& order);
+    static std::array<int, NumEffects> unpackOrder(juce::uint32 packed);
+
+    // 以下はオーディオスレッドのみが触る (ブロック境界で publishedOrder を取り込む)
+    juce::uint32 appliedOrder = 0;
+    juce::uint32 appliedBypassMask = 0;
+    std::array<FxCore*, NumEffects> activeChain{}; // バイパス中のエフェクトを除いた実行列
+    int activeCount = 0;
+    bool chainDirty = true;
+    bool stateCleared = true; // prepare / clear の後にまだ 1 度も鳴らしていない (並べ替えのフェードが要らない)
+
+    static constexpr double orderFadeMs = 3.0; // 並べ替え時のフェードアウト/イン時間
+    int orderFadeSamples = 132;
+
+    // 並べ替えのフェードの進み具合 (ブロックをまたいで持ち越す)
+    enum class OrderFade { None, Out, In };
+    OrderFade orderFade = OrderFade::None;
+    int orderFadePos = 0; // 現在のフェードの経過サンプル数
+
+    void rebuildActiveChain();
+    void runChain(juce::AudioBuffer<float>& buffer);
 };
@@ -0,0 +1,44 @@
+﻿#pragma once
+
+// ======================================================
+// PolyBLEP / PolyBLAMP (2 サンプル幅の多項式で不連続点をならし、折り返しを抑える)
+// t: 不連続点からの位相 (0.0 - 1.0、不連続点が 0)、dt: 1 サンプルあたりの位相の増分
+// 戻り値は補正量なので、素朴な波形に「段差の高さ × step()」「傾きの変化量 × ramp()」を足して使う
+// 不連続点の前後 1 サンプル以外は 0 を返す (dt は 0.5 未満であること)
+// ======================================================
+namespace PolyBlep
+{
+    // 高さ 1 の段差 (値が +1 跳ねる) の補正
+    inline float step(float t, float dt) noexcept
+    {
+        if (t < dt) {
+            const float x = t / dt - 1.0f; // 段差の直後 (-1 .. 0)
+            return -0.5f * x * x;
+        }
+        if (t > 1.0f - dt) {
+            const float x = (t - 1.0f) / dt + 1.0f; // 段差の直前 (0 .. 1)
+            return 0.5f * x * x;
+        }
+        return 0.0f;
+    }
+
+    // 傾きが 1 サンプルあたり 1 だけ増える折れ点の補正
+    inline float ramp(float t, float dt) noexcept
+    {
+        if (t < dt) {
+            const float x = 1.0f - t / dt; // 折れ点の直後 (1 .. 0)
+            return x * x * x * (1.0f / 6.0f);
+        }
+        if (t > 1.0f - dt) {
+            const float x = (t - 1.0f) / dt + 1.0f; // 折れ点の直前 (0 .. 1)
+            return x * x * x * (1.0f / 6.0f);
+        }
+        return 0.0f;
+    }
+
+    // 位相を 0.0 - 1.0 に折り返す (不連続点が offset にある波形用)
+    inline float wrap(float t) noexcept
+    {
+        return (t < 0.0f) ? t + 1.0f : ((t >= 1.0f) ? t - 1.0f : t);
+    }
+}
@@ -0,0 +1,326 @@
+﻿#include "./FmWaveTable.h"
+
+#include <cmath>
+
+const Opzx7WaveTable& Opzx7WaveTable::getInstance()
+{
+    static const Opzx7WaveTable instance;
+    return instance;
+}
+
+Opzx7WaveTable::Opzx7WaveTable()
+    : m_tables((size_t)waves * levels * (tableSize + 1), 0.0f)
+{
+    // 解析用は 4 倍でサンプリングし、テーブルに入る範囲の倍音を正しく取り出す
+    constexpr int analysisBits = tableBits + 2;
+    constexpr int analysisSize = 1 << analysisBits;
+
+    juce::dsp::FFT analysisFft(analysisBits);
+    juce::dsp::FFT tableFft(tableBits);
+
+    std::vector<float> spectrum((size_t)analysisSize * 2);
+    std::vector<float> work((size_t)tableSize * 2);
+
+    // 逆変換は 1/N で正規化されるので、解析側との長さの比で合わせる
+    const float scale = (float)tableSize / (float)analysisSize;
+
+    for (int wave = 0; wave < waves; ++wave)
+    {
+        std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+        for (int n = 0; n < analysisSize; ++n) {
+            spectrum[n] = calcAnalytic(juce::MathConstants<float>::twoPi * (float)n / (float)analysisSize, wave);
+        }
+
+        analysisFft.performRealOnlyForwardTransform(spectrum.data(), true);
+
+        for (int level = 0; level < levels; ++level)
+        {
+            // ナイキスト (tableSize / 2) の成分は位相が定まらないので含めない
+            int harmonics = std::min((tableSize / 2) >> level, tableSize / 2 - 1);
+
+            std::fill(work.begin(), work.end(), 0.0f);
+            for (int k = 0; k <= harmonics; ++k) {
+                work[k * 2] = spectrum[k * 2] * scale;
+                work[k * 2 + 1] = spectrum[k * 2 + 1] * scale;
+            }
+
+            tableFft.performRealOnlyInverseTransform(work.data());
+
+            float* table = m_tables.data() + ((size_t)wave * levels + level) * (tableSize + 1);
+            std::copy(work.begin(), work.begin() + tableSize, table);
+            table[tableSize] = table[0];
+        }
+    }
+}
+
+float Opzx7WaveTable::calcAnalytic(float p, int wave)
+{
+    // サイン波と正規化位相を計算
+    float s = std::sin(p);
+    float normPhase = p / (2.0f * juce::MathConstants<float>::pi);
+
+    // =================================================================
+    // 波形ごとの計算式
+    // =================================================================
+    int safeWave = std::clamp(wave, 0, Opzx7PrValue::waveShapes - 1);
+
+    // =================================================================
+    // 波形生成用のユーティリティ関数群
+    // =================================================================
+    auto isOddQuad = [](float phase) {
+        return phase < 0.25f || (phase >= 0.5f && phase < 0.75f);
+        };
+
+    auto doubleSine = [](float p) {
+        return std::sin(p * 2.0f);
+        };
+
+    auto halfLevelSign = [](float sine) {
+        if (sine > 0.5f) return 0.5f;
+        if (sine < -0.5f) return -0.5f;
+        return sine;
+        };
+
+    auto triangle = [](float phase) {
+        float value = phase * 4.0f;
+        if (phase < 0.25f) return value;
+        if (phase < 0.75f) return 2.0f - value;
+        return value - 4.0f;
+        };
+
+    auto dsTriangle = [](float phase) {
+        float position = phase >= 0.5f ? phase - 0.5f : phase;
+        float value = position * 8.0f;
+        if (position < 0.125f) return value;
+        if (position < 0.375f) return 2.0f - value;
+        return value - 4.0f;
+        };
+
+    auto diagram = [](float phase) {
+        float value = phase * 2.0f;
+        if (phase < 0.5f) return value;
+        return value - 2.0f;
+        };
+
+    auto dsDiagram = [](float phase) {
+        float position = phase >= 0.5f ? phase - 0.5f : phase;
+        float value = position * 4.0f;
+        if (position < 0.25f) return value;
+        return value - 2.0f;
+        };
+
+    auto absHalfSawUp = [](float phase) {
+        float value = phase * 2.0f;
+        if (phase < 0.5f) return value;
+        return value - 1.0f;
+        };
+
+    auto dsAbsHalfSawUp = [](float phase) {
+        float position = phase >= 0.5f ? phase - 0.5f : phase;
+        float value = position * 4.0f;
+        if (position < 0.25f) return value;
+        return value - 1.0f;
+        };
+
+    auto reverseSign = [](float phase, float nP) {
+        float s2 = std::sin(phase + 0.5f * juce::MathConstants<float>::pi);
+        if (nP < 0.25f) return 1.0f - s2;
+        if (nP < 0.5f) return 1.0f + s2;
+        if (nP < 0.75f) return -1.0f - s2;
+        return s2 - 1.0f;
+        };
+
+    auto doubleReverseSine = [](float phase, float nP) {
+        float s2 = std::sin((phase + 0.75f * juce::MathConstants<float>::pi) * 2.0f);
+        if (nP < 0.125f) return 1.0f + s2;
+        if (nP < 0.25f) return 1.0f - s2;
+        if (nP < 0.375f) return s2 - 1.0f;
+        return -1.0f - s2;
+        };
+
+    // =================================================================
+    // 波形ストラテジー配列の定義
+    // (引数: ラジアン位相 p, 正規化位相 n, サイン波 s)
+    // =================================================================
+    float val = 0.0f;
+    float sign = 0.0f;
+    uint8_t pi = 0;
+
+    switch (safeWave) {
+    case 0:
+        return s;
+    case 1:
+        return normPhase < 0.5f ? s : 0.0f;
+    case 2:
+        return std::abs(s);
+    case 3:
+        return isOddQuad(normPhase) ? std::abs(s) : 0.0f;
+    case 4:
+        return normPhase < 0.5f ? doubleSine(p) : 0.0f;
+    case 5:
+        return normPhase < 0.5f ? std::abs(doubleSine(p)) : 0.0f;
+    case 6:
+        return normPhase < 0.5f ? 1.0f : -1.0f;
+    case 7:
+        val = 1.0f - normPhase * 2.0f;
+        
+        return val * val * val;
+    case 8:
+        return halfLevelSign(s);
+    case 9:
+        return normPhase < 0.5f ? halfLevelSign(s) : 0.0f;
+    case 10:
+        return std::abs(halfLevelSign(s));
+    case 11:
+        return isOddQuad(normPhase) ? std::abs(halfLevelSign(s)) : 0.0f;
+    case 12:
+        return normPhase < 0.5f ? std::sin(p * 2.0f) * 0.5f : 0.0f;
+    case 13:
+        return normPhase < 0.5f ? std::abs(std::sin(p * 2.0f)) * 0.5f : 0.0f;
+    case 14:
+        return normPhase < 0.5f ? 1.0f : 0.0f;
+    case 15:
+        return 0.0f; // WT
+    case 16:
+        return triangle(normPhase);
+    case 17:
+        return normPhase < 0.5f ? triangle(normPhase) : 0.0f;
+    case 18:
+        return std::abs(triangle(normPhase));
+    case 19:
+        return isOddQuad(normPhase) ? std::abs(triangle(normPhase)) : 0.0f;
+    case 20:
+        return normPhase < 0.5f ? dsTriangle(normPhase) : 0.0f;
+    case 21:
+        return normPhase < 0.5f ? std::abs(dsTriangle(normPhase)) : 0.0f;
+    case 22:
+        return isOddQuad(normPhase) ? 1.0f : 0.0f;
+    case 23:
+        return 0.0f; // WT2
+    case 24:
+        return diagram(normPhase);
+    case 25:
+        return normPhase < 0.5f ? diagram(normPhase) : 0.0f;
+    case 26:
+        return absHalfSawUp(normPhase);
+    case 27:
+        return isOddQuad(normPhase) ? absHalfSawUp(normPhase) : 0.0f;
+    case 28:
+        return normPhase < 0.5f ? dsDiagram(normPhase) : 0.0f;
+    case 29:
+        return normPhase < 0.5f ? dsAbsHalfSawUp(normPhase) : 0.0f;
+    case 30:
+        return normPhase < 0.25f ? 1.0f : 0.0f;
+    case 31:
+        return 0.0f; // PCM
+    case 32:
+        return normPhase < 0.5f ? std::abs(std::sin(p * 2.0f)) : 0.0f;
+    case 33:
+        sign = (normPhase < 0.5f) ? 1.0f : -1.0f;
+        return sign * (1.0f - std::pow(1.0f - std::abs(s), 4.0f));
+    case 34:
+        return 1.0f - normPhase * 2.0f;
+    case 35:
+        return normPhase * 2.0f - 1.0f;
+    case 36:
+        return (1.0f - normPhase * 2.0f) * 0.5f + s * 0.5f;
+    case 37:
+        return normPhase < 0.25f ? 1.0f : -1.0f;
+    case 38:
+        return normPhase < 0.125f ? 1.0f : -1.0f;
+    case 39:
+        return normPhase < 0.0625f ? 1.0f : -1.0f;
+    case 40:
+        return std::tanh(s * 5.0f);
+    case 41:
+        return std::exp(-100.0f * std::pow(normPhase - 0.5f, 2.0f)) * 2.0f - 1.0f;
+    case 42:
+        return std::sin(p) + std::sin(p * 3.0f) * 0.5f + std::sin(p * 5.0f) * 0.25f;
+    case 43:
+        return (1.0f - normPhase * 2.0f) * std::sin(p * 4.0f);
+    case 44:
+        return (1.0f - normPhase * 2.0f) * std::sin(p * 8.0f);
+    case 45:
+        val = (normPhase < 0.5f ? (4.0f * normPhase - 1.0f) : (3.0f - 4.0f * normPhase));
+
+        return val * std::sin(p * 3.0f);
+    case 46:
+        return s * s * s;
+    case 47:
+        return std::sin(p) * std::sin(p * 2.0f);
+    case 48:
+        return s + 0.5f * std::sin(p * 2.0f) + 0.25f * std::sin(p * 4.0f);
+    case 49:
+        return s * std::cos(p * 2.5f);
+    case 50:
+        return std::sin(p) * std::sin(p * 1.414f);
+    case 51:
+        return std::sin(p) * std::cos(p * 0.5f);
+    case 52:
+        return std::sin(p * 13.0f) * std::cos(p * 7.0f) * std::sin(p * 2.0f);
+    case 53:
+        return (1.0f - std::cos(p)) * std::sin(p * 5.0f) * 0.5f;
+    case 54:
+        return (1.0f - std::cos(p)) * std::sin(p * 9.0f) * 0.5f;
+    case 55:
+        return std::round(s * 2.0f) / 2.0f;
+    case 56:
+        return std::round(s * 4.0f) / 4.0f;
+    case 57:
+        val = s * 1.5f;
+
+        if (val > 1.0f) return 2.0f - val;
+        if (val < -1.0f) return -2.0f - val;
+
+        return val;
+    case 58:
+        val = s * 2.5f;
+
+        return std::sin(val * juce::MathConstants<float>::halfPi);
+    case 59:
+        pi = (uint8_t)(normPhase * 255.0f);
+        pi = pi ^ (pi >> 1);
+        
+        return ((float)pi / 255.0f) * 2.0f - 1.0f;
+    case 60:
+        pi = (uint8_t)(normPhase * 255.0f);
+        pi = pi & (pi << 1);
+
+        return ((float)pi / 255.0f) * 2.0f - 1.0f;
+    case 61:
+        return std::sin(p + 1.0f * std::sin(p));
+    case 62:
+        return std::sin(p + 2.0f * std::sin(p));
+    case 63:
+        return reverseSign(p, normPhase);
+    case 64:
+        return normPhase < 0.5f ? s : 0.0f;
+    case 65:
+        return normPhase < 0.5f ? reverseSign(p, normPhase) : 0.0f;
+    case 66:
+        return normPhase < 0.5f ? doubleSine(p) : 0.0f;
+    case 67:
+        return normPhase < 0.5f ? doubleReverseSine(p, normPhase) : 0.0f;
+    case 68:
+        return normPhase < 0.5f ? std::abs(doubleSine(p)) : 0.0f;
+    case 69:
+        return normPhase < 0.5f ? std::abs(doubleReverseSine(p, normPhase)) : 0.0f;
+    case 70:
+        val = triangle(normPhase);
+        
+        return val * val * val;
+    case 71:
+        val = triangle(normPhase);
+        sign = (val >= 0.0f) ? 1.0f : -1.0f;
+        val = std::abs(val);
+
+        return sign * (1.0f - std::sqrt(std::max(0.0f, 1.0f - val * val)));
+    case 72:
+        val = std::fmod(normPhase * 2.0f, 1.0f);
+        sign = (normPhase < 0.5f) ? 1.0f : -1.0f;
+
+        return sign * std::exp(-val * 8.0f);
+    default:
+        return s;
+    }
+}
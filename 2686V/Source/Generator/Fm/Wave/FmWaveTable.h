@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+#include "../../../Processor/Opzx7/ProcessorOpzx7Values.h"
+
+// OPZX7 の解析的な波形を帯域制限して焼き込んだミップマップテーブル
+// レベル L は倍音を (tableSize / 2) >> L 次までに制限したもの
+// 高い音ほど倍音の少ないレベルを引くので、角のある波形でも折り返しが出にくい
+class Opzx7WaveTable
+{
+public:
+    static constexpr int tableBits = 11;
+    static constexpr int tableSize = 1 << tableBits; // 2048
+    static constexpr int levels = tableBits;         // 倍音上限 1024, 512, ..., 1
+    static constexpr int waves = Opzx7PrValue::waveShapes;
+
+    // 初回呼び出し時に全テーブルを作成する (オペレータの生成時に呼ばれる)
+    static const Opzx7WaveTable& getInstance();
+
+    // 解析式による波形 (テーブル作成用。p: ラジアン位相 0 ~ 2π)
+    static float calcAnalytic(float p, int wave);
+
+    // 1サンプルあたりの位相増分 (周期単位) から、ナイキストを超えない最も倍音の多いレベルを選ぶ
+    static inline int getLevel(float cyclesPerSample) noexcept {
+        float limit = 0.5f / std::max(std::abs(cyclesPerSample), 1.0e-9f);
+        int harmonics = tableSize / 2;
+        int level = 0;
+
+        while (level < levels - 1 && (float)harmonics > limit) {
+            harmonics >>= 1;
+            ++level;
+        }
+
+        return level;
+    }
+
+    // normPhase: 正規化位相 (0.0 ~ 1.0)
+    inline float lookup(int wave, int level, float normPhase) const noexcept {
+        const float* table = m_tables.data() + ((size_t)wave * levels + level) * (tableSize + 1);
+
+        float pos = normPhase * (float)tableSize;
+        int i = (int)pos;
+        if (i >= tableSize) i = tableSize - 1;
+
+        float frac = pos - (float)i;
+        return table[i] + (table[i + 1] - table[i]) * frac;
+    }
+private:
+    Opzx7WaveTable();
+
+    // [wave][level][tableSize + 1] (末尾は先頭のコピー)
+    std::vector<float> m_tables;
+};
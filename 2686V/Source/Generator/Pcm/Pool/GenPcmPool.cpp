@@ -0,0 +1,230 @@
+﻿#include "./GenPcmPool.h"
+
+#include "../Adpcm/GenAdpcm.h"
+#include "../Dpcm/GenDpcm.h"
+#include "../Helper/GenPcmHelper.h"
+
+// ============================================================================
+// PcmSample
+// ============================================================================
+PcmSample::~PcmSample()
+{
+    int num = m_numEncoded.load(std::memory_order_acquire);
+    for (int i = 0; i < num; ++i) {
+        delete m_encoded[i];
+    }
+}
+
+const PcmEncoded* PcmSample::findEncoded(int qualityMode, double sampleRate) const noexcept
+{
+    bool isDpcm = (qualityMode == dpcmMode);
+    int num = m_numEncoded.load(std::memory_order_acquire);
+
+    for (int i = 0; i < num; ++i) {
+        if (m_encoded[i]->isDpcm == isDpcm && m_encoded[i]->sampleRate == sampleRate) {
+            return m_encoded[i];
+        }
+    }
+
+    return nullptr;
+}
+
+const PcmEncoded* PcmSample::addEncoded(std::unique_ptr<PcmEncoded> encoded)
+{
+    int num = m_numEncoded.load(std::memory_order_relaxed);
+    if (num >= maxEncodings) return nullptr;
+
+    m_encoded[num] = encoded.release();
+    m_numEncoded.store(num + 1, std::memory_order_release);
+
+    return m_encoded[num];
+}
+
+// ============================================================================
+// GenPcmPool
+// ============================================================================
+GenPcmPool::GenPcmPool(juce::AudioFormatManager& formatManager)
+    : juce::Thread("PcmSampleLoader"), m_formatManager(formatManager)
+{
+    startThread();
+}
+
+GenPcmPool::~GenPcmPool()
+{
+    stopThread(5000);
+}
+
+void GenPcmPool::loadAsync(const juce::File& file, int qualityMode, double targetRate, LoadCallback onLoaded)
+{
+    {
+        const juce::ScopedLock lock(m_requestLock);
+        m_requests.push_back({ file, qualityMode, targetRate, std::move(onLoaded) });
+        m_numPending.fetch_add(1, std::memory_order_release);
+    }
+
+    notify();
+}
+
+void GenPcmPool::setIdleCallback(std::function<void()> onIdle)
+{
+    const juce::ScopedLock lock(m_requestLock);
+    m_onIdle = std::move(onIdle);
+}
+
+void GenPcmPool::run()
+{
+    while (!threadShouldExit()) {
+        Request request;
+        bool hasRequest = false;
+        std::function<void()> onIdle;
+        {
+            const juce::ScopedLock lock(m_requestLock);
+            if (!m_requests.empty()) {
+                request = std::move(m_requests.front());
+                m_requests.pop_front();
+                hasRequest = true;
+            }
+            else {
+                onIdle = m_onIdle;
+            }
+        }
+
+        if (!hasRequest) {
+            if (onIdle) onIdle();
+
+            purge();
+            wait(pollIntervalMs);
+            continue;
+        }
+
+        auto sample = load(request.file);
+
+        // 現在の設定のエンコード結果も先に作っておく
+        if (sample != nullptr) {
+            prepareEncoded(*sample, request.qualityMode, request.targetRate);
+        }
+
+        if (request.onLoaded) request.onLoaded(sample);
+
+        m_numPending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+PcmSample::Ptr GenPcmPool::load(const juce::File& file)
+{
+    auto path = file.getFullPathName();
+    auto modificationTime = file.getLastModificationTime();
+
+    for (auto* sample : m_samples) {
+        if (sample->path == path && sample->modificationTime == modificationTime) {
+            return sample;
+        }
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader(m_formatManager.createReaderFor(file));
+    if (reader == nullptr) return nullptr;
+
+    juce::AudioBuffer<float> fileBuffer;
+    fileBuffer.setSize((int)reader->numChannels, (int)reader->lengthInSamples);
+    reader->read(&fileBuffer, 0, (int)reader->lengthInSamples, 0, true, true);
+
+    PcmSample::Ptr sample = new PcmSample();
+    sample->path = path;
+    sample->modificationTime = modificationTime;
+    sample->sourceRate = reader->sampleRate;
+
+    // Lチャンネルのみ使用
+    auto* channelData = fileBuffer.getReadPointer(0);
+    sample->raw.assign(channelData, channelData + fileBuffer.getNumSamples());
+
+    purge();
+    m_samples.add(sample);
+
+    return sample;
+}
+
+void GenPcmPool::purge()
+{
+    for (int i = m_samples.size(); --i >= 0;) {
+        if (m_samples.getObjectPointerUnchecked(i)->getReferenceCount() == 1) {
+            m_samples.remove(i);
+        }
+    }
+}
+
+const PcmEncoded* GenPcmPool::prepareEncoded(PcmSample& sample, int qualityMode, double targetRate)
+{
+    if (qualityMode != adpcmMode && qualityMode != dpcmMode) return nullptr;
+    if (sample.raw.empty()) return nullptr;
+
+    if (auto* encoded = sample.findEncoded(qualityMode, getEncodedRate(sample, targetRate))) {
+        return encoded;
+    }
+
+    return sample.addEncoded(encode(sample, qualityMode, targetRate));
+}
+
+double GenPcmPool::getEncodedRate(const PcmSample& sample, double targetRate)
+{
+    // Do not upsample beyond source rate for the ADPCM buffer gen
+    return (targetRate > sample.sourceRate) ? sample.sourceRate : targetRate;
+}
+
+std::unique_ptr<PcmEncoded> GenPcmPool::encode(const PcmSample& sample, int qualityMode, double targetRate)
+{
+    auto encoded = std::make_unique<PcmEncoded>();
+    encoded->isDpcm = (qualityMode == dpcmMode);
+    encoded->sampleRate = getEncodedRate(sample, targetRate);
+
+    const auto& rawBuffer = sample.raw;
+    if (rawBuffer.empty()) return encoded;
+
+    // Resample & Encode
+    double step = sample.sourceRate / encoded->sampleRate;
+    if (step <= 0.0) step = 1.0;
+
+    auto& pcmBuffer = encoded->data;
+    pcmBuffer.reserve((size_t)(rawBuffer.size() / step) + 1);
+
+    double pos = 0;
+
+    // --- DPCMとADPCMの分岐エンコード ---
+    if (encoded->isDpcm)
+    {
+        DpcmCodec codec;
+        codec.reset();
+
+        while (pos < rawBuffer.size()) {
+            int index = (int)pos;
+
+            if (index >= rawBuffer.size()) break;
+
+            int16_t input = (int16_t)(rawBuffer[index] * 32767.0f);
+
+            pcmBuffer.push_back(codec.decode(codec.encode(input)));
+
+            pos += step;
+        }
+    }
+    else
+    {
+        Ym2608AdpcmCodec codec;
+        codec.reset();
+
+        while (pos < rawBuffer.size()) {
+            int index = (int)pos;
+
+            if (index >= rawBuffer.size()) break;
+
+            int16_t input = (int16_t)(rawBuffer[index] * 32767.0f);
+
+            pcmBuffer.push_back(codec.decode(codec.encode(input)));
+
+            pos += step;
+        }
+    }
+
+    GenPcmHelper::lowPassFilter(pcmBuffer);
+
+    return encoded;
+}
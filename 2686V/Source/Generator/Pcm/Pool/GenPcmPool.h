@@ -0,0 +1,97 @@
+﻿#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// ADPCM / DPCM でエンコードしたバッファ (作成後は変更しない)
+struct PcmEncoded
+{
+    bool isDpcm = false;
+    double sampleRate = 16000.0; // エンコード後のレート
+    std::vector<int16_t> data;   // Processed Data (4bit ADPCM/DPCM)
+};
+
+// 読み込み済みのサンプル (読み込み後は変更しない)
+// プロセッサが参照カウントで保持し、各ボイスはポインタで参照する
+struct PcmSample : public juce::ReferenceCountedObject
+{
+    using Ptr = juce::ReferenceCountedObjectPtr<PcmSample>;
+
+    static constexpr int maxEncodings = 64;
+
+    juce::String path;
+    juce::Time modificationTime;
+    std::vector<float> raw; // Raw Data (32bit, mono)
+    double sourceRate = 44100.0;
+
+    ~PcmSample() override;
+
+    // 登録済みのエンコード結果を探す (ロックしないのでオーディオスレッドから呼べる)
+    const PcmEncoded* findEncoded(int qualityMode, double sampleRate) const noexcept;
+    // プールのスレッドからのみ呼ぶ
+    const PcmEncoded* addEncoded(std::unique_ptr<PcmEncoded> encoded);
+private:
+    std::array<PcmEncoded*, maxEncodings> m_encoded{};
+    std::atomic<int> m_numEncoded{ 0 };
+};
+
+// ADPCM / Rhythm で共有するサンプルの置き場
+// ファイルの読み込みとエンコードは専用スレッドで行い、結果をコールバックで返す
+class GenPcmPool : private juce::Thread
+{
+public:
+    // 読み込み完了時にプールのスレッドから呼ばれる (失敗時は nullptr)
+    using LoadCallback = std::function<void(PcmSample::Ptr)>;
+
+    explicit GenPcmPool(juce::AudioFormatManager& formatManager);
+    ~GenPcmPool() override;
+
+    // qualityMode / targetRate は読み込みと同時に作っておくエンコードの設定
+    void loadAsync(const juce::File& file, int qualityMode, double targetRate, LoadCallback onLoaded);
+
+    // 読み込み要求が無い間、pollIntervalMs ごとにプールのスレッドから呼ばれる
+    // (設定変更で必要になったエンコードをここで作る)
+    void setIdleCallback(std::function<void()> onIdle);
+
+    // 未処理 (読み込み中を含む) の読み込み要求があるか
+    bool isLoading() const noexcept { return m_numPending.load(std::memory_order_acquire) > 0; }
+
+    // 未作成ならエンコードして登録する (プールのスレッドからのみ呼ぶ)
+    static const PcmEncoded* prepareEncoded(PcmSample& sample, int qualityMode, double targetRate);
+
+    // エンコード後の実際のレート (ソースより高いレートにはしない)
+    static double getEncodedRate(const PcmSample& sample, double targetRate);
+private:
+    struct Request
+    {
+        juce::File file;
+        int qualityMode = 0;
+        double targetRate = 16000.0;
+        LoadCallback onLoaded;
+    };
+
+    static constexpr int pollIntervalMs = 20; // エンコード要求の確認間隔
+
+    juce::AudioFormatManager& m_formatManager;
+
+    juce::CriticalSection m_requestLock;
+    std::deque<Request> m_requests;
+    std::function<void()> m_onIdle;
+    std::atomic<int> m_numPending{ 0 }; // コールバックを呼び終えるまで数える
+
+    // 以下はプールのスレッドのみが触る
+    juce::ReferenceCountedArray<PcmSample> m_samples;
+
+    void run() override;
+    // 同じファイル (パス・更新日時が同じ) は読み込み済みのものを返す
+    PcmSample::Ptr load(const juce::File& file);
+    // プール以外から参照されなくなったサンプルを解放する
+    void purge();
+    // リサンプル + ADPCM/DPCM エンコード + ローパス
+    static std::unique_ptr<PcmEncoded> encode(const PcmSample& sample, int qualityMode, double targetRate);
+};
@@ -0,0 +1,277 @@
+﻿#include "./PresetIndex.h"
+
+#include "../../Core/Const/ConstFileValues.h"
+#include "./PresetKeys.h"
+#include "./PresetValues.h"
+
+PresetIndex::PresetIndex()
+    : juce::Thread("PresetIndexScanner")
+{
+    auto docDir = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory);
+    m_indexFile = docDir.getChildFile(Io::Folder::asset).getChildFile(PresetValue::File::Name::index);
+
+    // 前回のキャッシュはすぐに使えるよう、ここで読んでおく
+    loadIndexFile();
+
+    startThread();
+}
+
+PresetIndex::~PresetIndex()
+{
+    stopThread(5000);
+}
+
+std::vector<PresetItem> PresetIndex::getItems(const juce::File& folder) const
+{
+    const juce::ScopedLock lock(m_lock);
+
+    if (m_scannedFolder == folder) return m_items;
+
+    std::vector<PresetItem> items;
+    for (const auto& [path, entry] : m_entries) {
+        if (isInFolder(path, folder)) items.push_back(entry.item);
+    }
+
+    return items;
+}
+
+void PresetIndex::scan(const juce::File& folder)
+{
+    {
+        const juce::ScopedLock lock(m_lock);
+        m_requestedFolder = folder;
+        m_scanRequested = true;
+    }
+
+    notify();
+}
+
+void PresetIndex::run()
+{
+    while (!threadShouldExit())
+    {
+        juce::File folder;
+        bool requested = false;
+        {
+            const juce::ScopedLock lock(m_lock);
+            requested = m_scanRequested;
+            folder = m_requestedFolder;
+            m_scanRequested = false;
+        }
+
+        if (!requested) {
+            wait(-1);
+            continue;
+        }
+
+        if (scanFolder(folder) && m_dirty) {
+            saveIndexFile();
+            m_dirty = false;
+        }
+    }
+}
+
+bool PresetIndex::isScanCancelled()
+{
+    if (threadShouldExit()) return true;
+
+    const juce::ScopedLock lock(m_lock);
+    return m_scanRequested;
+}
+
+bool PresetIndex::scanFolder(const juce::File& folder)
+{
+    if (!folder.isDirectory()) {
+        publish(folder, {});
+        return true;
+    }
+
+    auto files = folder.findChildFiles(juce::File::findFiles, true, PresetValue::File::glob);
+
+    // 1. 更新日時・サイズでキャッシュと突き合わせる (XML はまだ読まない)
+    std::vector<PresetItem> items;
+    std::vector<size_t> staleIndices;
+    items.reserve((size_t)files.size());
+
+    {
+        const juce::ScopedLock lock(m_lock);
+
+        std::set<juce::String> found;
+        for (const auto& file : files)
+        {
+            auto path = file.getFullPathName();
+            found.insert(path);
+            auto size = file.getSize();
+            auto modified = file.getLastModificationTime();
+
+            auto it = m_entries.find(path);
+            if (it != m_entries.end() && it->second.size == size && it->second.modified == modified.toMilliseconds()) {
+                items.push_back(it->second.item);
+                continue;
+            }
+
+            // 読み終わるまではファイル名だけ表示する
+            PresetItem item;
+            item.file = file;
+            item.fileName = file.getFileName();
+            item.fullPath = path;
+            item.lastModificationTime = modified;
+            item.name = file.getFileNameWithoutExtension();
+            item.modeName = PresetValue::MetaData::Initial::mode;
+
+            staleIndices.push_back(items.size());
+            items.push_back(item);
+        }
+
+        // 消えたファイルをキャッシュから外す
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (found.count(it->first) == 0 && isInFolder(it->first, folder)) {
+                it = m_entries.erase(it);
+                m_dirty = true;
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    publish(folder, items);
+
+    // 2. 変更のあったファイルだけメタデータを読む
+    int sinceLastPublish = 0;
+    for (auto index : staleIndices)
+    {
+        if (isScanCancelled()) return false;
+
+        auto& item = items[index];
+        item = readMetaData(item.file);
+
+        Entry entry;
+        entry.item = item;
+        entry.size = item.file.getSize();
+        entry.modified = item.lastModificationTime.toMilliseconds();
+
+        {
+            const juce::ScopedLock lock(m_lock);
+            m_entries[item.fullPath] = entry;
+        }
+        m_dirty = true;
+
+        if (++sinceLastPublish >= PresetValue::File::Index::publishInterval) {
+            publish(folder, items);
+            sinceLastPublish = 0;
+        }
+    }
+
+    if (sinceLastPublish > 0) publish(folder, items);
+
+    return true;
+}
+
+void PresetIndex::publish(const juce::File& folder, const std::vector<PresetItem>& items)
+{
+    {
+        const juce::ScopedLock lock(m_lock);
+        m_scannedFolder = folder;
+        m_items = items;
+    }
+
+    sendChangeMessage();
+}
+
+PresetItem PresetIndex::readMetaData(const juce::File& file)
+{
+    PresetItem item;
+    item.file = file;
+    item.fileName = file.getFileName();
+    item.fullPath = file.getFullPathName();
+    item.lastModificationTime = file.getLastModificationTime();
+
+    // メタデータはルート要素の属性にしか無いので、子要素 (パラメータ) は読まない
+    juce::XmlDocument xmlDoc(file);
+    auto xml = xmlDoc.getDocumentElement(true);
+    if (xml != nullptr)
+    {
+        item.name = xml->getStringAttribute(PresetKey::name, PresetValue::MetaData::Initial::name);
+        item.author = xml->getStringAttribute(PresetKey::author, PresetValue::MetaData::Initial::author);
+        item.version = xml->getStringAttribute(PresetKey::version, PresetValue::MetaData::Initial::version);
+        item.comment = xml->getStringAttribute(PresetKey::comment, PresetValue::MetaData::Initial::comment);
+        item.modeName = xml->getStringAttribute(PresetKey::mode, PresetValue::MetaData::Initial::mode);
+        item.genre = xml->getStringAttribute(PresetKey::genre, PresetValue::MetaData::Initial::genre);
+    }
+    else
+    {
+        item.name = PresetValue::File::Message::invalidXmlNotice;
+    }
+
+    return item;
+}
+
+bool PresetIndex::isInFolder(const juce::String& path, const juce::File& folder)
+{
+    return juce::File(path).isAChildOf(folder);
+}
+
+void PresetIndex::loadIndexFile()
+{
+    if (!m_indexFile.existsAsFile()) return;
+
+    auto xml = juce::XmlDocument::parse(m_indexFile);
+    if (xml == nullptr || !xml->hasTagName(PresetKey::Index::root)) return;
+
+    // 書式が違うキャッシュは使わない (次の走査で作り直す)
+    if (xml->getIntAttribute(PresetKey::Index::formatVersion) != PresetValue::File::Index::formatVersion) return;
+
+    const juce::ScopedLock lock(m_lock);
+
+    for (auto* child : xml->getChildWithTagNameIterator(PresetKey::Index::entry))
+    {
+        Entry entry;
+        auto path = child->getStringAttribute(PresetKey::Index::path);
+        if (path.isEmpty()) continue;
+
+        entry.size = child->getStringAttribute(PresetKey::Index::size).getLargeIntValue();
+        entry.modified = child->getStringAttribute(PresetKey::Index::modified).getLargeIntValue();
+
+        auto& item = entry.item;
+        item.file = juce::File(path);
+        item.fileName = item.file.getFileName();
+        item.fullPath = path;
+        item.lastModificationTime = juce::Time(entry.modified);
+        item.name = child->getStringAttribute(PresetKey::name);
+        item.author = child->getStringAttribute(PresetKey::author);
+        item.version = child->getStringAttribute(PresetKey::version);
+        item.comment = child->getStringAttribute(PresetKey::comment);
+        item.modeName = child->getStringAttribute(PresetKey::mode);
+        item.genre = child->getStringAttribute(PresetKey::genre);
+
+        m_entries[path] = entry;
+    }
+}
+
+void PresetIndex::saveIndexFile()
+{
+    juce::XmlElement xml(PresetKey::Index::root);
+    xml.setAttribute(PresetKey::Index::formatVersion, PresetValue::File::Index::formatVersion);
+
+    {
+        const juce::ScopedLock lock(m_lock);
+
+        for (const auto& [path, entry] : m_entries)
+        {
+            auto* child = xml.createNewChildElement(PresetKey::Index::entry);
+            child->setAttribute(PresetKey::Index::path, path);
+            child->setAttribute(PresetKey::Index::size, juce::String(entry.size));
+            child->setAttribute(PresetKey::Index::modified, juce::String(entry.modified));
+            child->setAttribute(PresetKey::name, entry.item.name);
+            child->setAttribute(PresetKey::author, entry.item.author);
+            child->setAttribute(PresetKey::version, entry.item.version);
+            child->setAttribute(PresetKey::comment, entry.item.comment);
+            child->setAttribute(PresetKey::mode, entry.item.modeName);
+            child->setAttribute(PresetKey::genre, entry.item.genre);
+        }
+    }
+
+    m_indexFile.getParentDirectory().createDirectory();
+    xml.writeTo(m_indexFile);
+}
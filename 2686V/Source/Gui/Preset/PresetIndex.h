@@ -0,0 +1,57 @@
+﻿#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "../../Core/Gui/GuiStructs.h"
+
+// プリセットのメタデータのキャッシュ
+// パス・更新日時・サイズが同じファイルは XML を読み直さない
+// フォルダの走査は専用スレッドで行い、途中経過もチェンジメッセージで通知する
+class PresetIndex : public juce::ChangeBroadcaster, private juce::Thread
+{
+public:
+    PresetIndex();
+    ~PresetIndex() override;
+
+    // folder 以下のプリセット一覧を返す
+    // 走査が済んでいなければキャッシュにある分だけを返す (メッセージスレッドから呼ぶ)
+    std::vector<PresetItem> getItems(const juce::File& folder) const;
+
+    // folder の走査を要求する (走査中の別フォルダは打ち切る)
+    void scan(const juce::File& folder);
+private:
+    struct Entry
+    {
+        PresetItem item;
+        juce::int64 size = 0;
+        juce::int64 modified = 0; // ミリ秒
+    };
+
+    juce::File m_indexFile;
+
+    mutable juce::CriticalSection m_lock;
+    std::map<juce::String, Entry> m_entries; // パスがキー (m_lock で保護)
+    juce::File m_scannedFolder;              // m_items の走査元 (m_lock で保護)
+    std::vector<PresetItem> m_items;         // 走査結果 (m_lock で保護)
+    juce::File m_requestedFolder;            // m_lock で保護
+    bool m_scanRequested = false;            // m_lock で保護
+
+    // 以下は走査スレッドのみが触る
+    bool m_dirty = false;
+
+    void run() override;
+    // 新しい要求が来たら false を返して打ち切る
+    bool scanFolder(const juce::File& folder);
+    bool isScanCancelled();
+    void publish(const juce::File& folder, const std::vector<PresetItem>& items);
+
+    void loadIndexFile();
+    void saveIndexFile();
+
+    // ルート要素の属性だけを読む (子要素のパラメータは読まない)
+    static PresetItem readMetaData(const juce::File& file);
+    static bool isInFolder(const juce::String& path, const juce::File& folder);
+};
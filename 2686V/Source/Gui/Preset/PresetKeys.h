@@ -68,4 +68,15 @@ namespace PresetKey
 	static inline const juce::String opzx7PathPrefix = "opzx7PcmPath";
 	static inline const juce::String opzx7WtPathPrefix = "opzx7WtPath";
 	static inline const juce::String opzx7Wt2PathPrefix = "opzx7Wt2Path";
+
+	// プリセット一覧のキャッシュ (メタデータのインデックス) 用
+	namespace Index
+	{
+		static inline const juce::String root = "PresetIndex";
+		static inline const juce::String entry = "Preset";
+		static inline const juce::String formatVersion = "formatVersion";
+		static inline const juce::String path = "path";
+		static inline const juce::String size = "size";
+		static inline const juce::String modified = "modified";
+	}
 };
@@ -52,6 +52,13 @@ namespace PresetValue
 		namespace Name
 		{
 			static inline const juce::String initial = "init_preset_vl.xml";
+			static inline const juce::String index = "preset_index.xml"; // メタデータのキャッシュ
+		}
+
+		namespace Index
+		{
+			static inline const int formatVersion = 1; // 書式を変えたら上げる (古いキャッシュは捨てる)
+			static inline const int publishInterval = 64; // この件数を読むごとに一覧へ反映する
 		}
 
 		namespace Message
@@ -529,6 +529,79 @@ void GuiSettings::setup()
 
     separator6.setupComponent(*this);
 
+    // --- Polyphony / Unison Limit ---
+    // 変更するとボイスを確保し直す (発音中の音は止まる)
+    std::vector<SelectItem> polyphonyItems;
+    for (int i = Global::Polyphony::min; i <= Global::Polyphony::max; ++i) {
+        polyphonyItems.push_back({ .name = juce::String(i), .value = i });
+    }
+
+    polyphonySelector.setup({ .parent = *this, .title = juce::String("") + "最大同時発音数", .items = polyphonyItems, .isReset = false });
+    polyphonySelector.setSelectedId(ctx.audioProcessor.getPolyphony(), juce::dontSendNotification);
+    polyphonySelector.setWantsKeyboardFocus(true);
+    polyphonySelector.setExplicitFocusOrder(++tabOrder);
+    polyphonySelector.onChange = [this] {
+        ctx.audioProcessor.setVoiceLimits(polyphonySelector.getSelectedId(), ctx.audioProcessor.getUnisonLimit());
+        };
+
+    std::vector<SelectItem> unisonLimitItems;
+    for (int i = 1; i <= Global::unisonVoices; ++i) {
+        unisonLimitItems.push_back({ .name = juce::String(i), .value = i });
+    }
+
+    unisonLimitSelector.setup({ .parent = *this, .title = juce::String("") + "ユニゾン上限", .items = unisonLimitItems, .isReset = false });
+    unisonLimitSelector.setSelectedId(ctx.audioProcessor.getUnisonLimit(), juce::dontSendNotification);
+    unisonLimitSelector.setWantsKeyboardFocus(true);
+    unisonLimitSelector.setExplicitFocusOrder(++tabOrder);
+    unisonLimitSelector.onChange = [this] {
+        ctx.audioProcessor.setVoiceLimits(ctx.audioProcessor.getPolyphony(), unisonLimitSelector.getSelectedId());
+        };
+
+    // コンボボックスの ID に 0 は使えないので、スレッド数 + 1 を ID にする
+    std::vector<SelectItem> renderThreadsItems;
+    const int maxRenderThreads = std::clamp(juce::SystemStats::getNumCpus() - 1, Global::RenderThreads::min, Global::RenderThreads::max);
+    for (int i = Global::RenderThreads::min; i <= maxRenderThreads; ++i) {
+        renderThreadsItems.push_back({ .name = (i == 0) ? juce::String("オフ") : juce::String(i), .value = i + 1 });
+    }
+
+    renderThreadsSelector.setup({ .parent = *this, .title = juce::String("") + "描画スレッド数", .items = renderThreadsItems, .isReset = false });
+    renderThreadsSelector.setSelectedId(ctx.audioProcessor.getRenderThreads() + 1, juce::dontSendNotification);
+    renderThreadsSelector.setWantsKeyboardFocus(true);
+    renderThreadsSelector.setExplicitFocusOrder(++tabOrder);
+    renderThreadsSelector.onChange = [this] {
+        ctx.audioProcessor.setRenderThreads(renderThreadsSelector.getSelectedId() - 1);
+        };
+
+    // ID は品質 + 1 (Global::ResampleQuality の並び)
+    std::vector<SelectItem> resampleQualityItems = {
+        { .name = juce::String("") + "リニア (軽量)", .value = Global::ResampleQuality::min + 1 },
+        { .name = juce::String("") + "標準", .value = Global::ResampleQuality::min + 2 },
+        { .name = juce::String("") + "高品質", .value = Global::ResampleQuality::min + 3 },
+    };
+
+    resampleQualitySelector.setup({ .parent = *this, .title = juce::String("") + "レート変換品質", .items = resampleQualityItems, .isReset = false });
+    resampleQualitySelector.setSelectedId(ctx.audioProcessor.getResampleQuality() + 1, juce::dontSendNotification);
+    resampleQualitySelector.setWantsKeyboardFocus(true);
+    resampleQualitySelector.setExplicitFocusOrder(++tabOrder);
+    resampleQualitySelector.onChange = [this] {
+        ctx.audioProcessor.setResampleQuality(resampleQualitySelector.getSelectedId() - 1);
+        };
+
+    std::vector<SelectItem> oscAntialiasItems = {
+        { .name = juce::String("") + "オフ", .value = 1 },
+        { .name = "PolyBLEP", .value = 2 },
+    };
+
+    oscAntialiasSelector.setup({ .parent = *this, .title = juce::String("") + "オシレーターのエイリアス除去", .items = oscAntialiasItems, .isReset = false });
+    oscAntialiasSelector.setSelectedId(ctx.audioProcessor.getOscAntialias() ? 2 : 1, juce::dontSendNotification);
+    oscAntialiasSelector.setWantsKeyboardFocus(true);
+    oscAntialiasSelector.setExplicitFocusOrder(++tabOrder);
+    oscAntialiasSelector.onChange = [this] {
+        ctx.audioProcessor.setOscAntialias(oscAntialiasSelector.getSelectedId() == 2);
+        };
+
+    separator8.setupComponent(*this);
+
     // --- Save Preference Button ---
     saveSettingsBtn.setup({ .parent = *this, .title = juce::String("") + "設定ファイルに保存", .isReset = false });
     saveSettingsBtn.setWantsKeyboardFocus(true);
@@ -824,14 +897,45 @@ void GuiSettings::layout(juce::Rectangle<int> content)
 
     separator6.layoutComponent(sRect);
 
-    // 12. Config IO Buttons (Fixed Layout)
+    // 12. Polyphony / Unison Limit / Render Threads / Resample Quality / Osc Anti-aliasing Row
+    auto rowPolyphony = sRect.removeFromTop(SettingsGuiValue::Settings::RowHeight);
+    polyphonySelector.label.setBounds(rowPolyphony.removeFromLeft(SettingsGuiValue::Settings::LabelWidth));
+    polyphonySelector.setBounds(rowPolyphony.removeFromLeft(SettingsGuiValue::Settings::VoiceLimitSelectorWidth));
+
+    sRect.removeFromTop(SettingsGuiValue::Settings::PaddingHeight);
+
+    auto rowUnisonLimit = sRect.removeFromTop(SettingsGuiValue::Settings::RowHeight);
+    unisonLimitSelector.label.setBounds(rowUnisonLimit.removeFromLeft(SettingsGuiValue::Settings::LabelWidth));
+    unisonLimitSelector.setBounds(rowUnisonLimit.removeFromLeft(SettingsGuiValue::Settings::VoiceLimitSelectorWidth));
+
+    sRect.removeFromTop(SettingsGuiValue::Settings::PaddingHeight);
+
+    auto rowRenderThreads = sRect.removeFromTop(SettingsGuiValue::Settings::RowHeight);
+    renderThreadsSelector.label.setBounds(rowRenderThreads.removeFromLeft(SettingsGuiValue::Settings::LabelWidth));
+    renderThreadsSelector.setBounds(rowRenderThreads.removeFromLeft(SettingsGuiValue::Settings::VoiceLimitSelectorWidth));
+
+    sRect.removeFromTop(SettingsGuiValue::Settings::PaddingHeight);
+
+    auto rowResampleQuality = sRect.removeFromTop(SettingsGuiValue::Settings::RowHeight);
+    resampleQualitySelector.label.setBounds(rowResampleQuality.removeFromLeft(SettingsGuiValue::Settings::LabelWidth));
+    resampleQualitySelector.setBounds(rowResampleQuality.removeFromLeft(SettingsGuiValue::Settings::VoiceLimitSelectorWidth));
+
+    sRect.removeFromTop(SettingsGuiValue::Settings::PaddingHeight);
+
+    auto rowOscAntialias = sRect.removeFromTop(SettingsGuiValue::Settings::RowHeight);
+    oscAntialiasSelector.label.setBounds(rowOscAntialias.removeFromLeft(SettingsGuiValue::Settings::LabelWidth));
+    oscAntialiasSelector.setBounds(rowOscAntialias.removeFromLeft(SettingsGuiValue::Settings::VoiceLimitSelectorWidth));
+
+    separator8.layoutComponent(sRect);
+
+    // 13. Config IO Buttons (Fixed Layout)
     auto rowIoBtns = sRect.removeFromTop(SettingsGuiValue::Settings::RowHeight);
 
     layoutRowSettingsIo({ .rect = rowIoBtns, .loadSettingsBtn = &loadSettingsBtn, .saveSettingsBtn = &saveSettingsBtn, .saveStartupSettingsBtn = &saveStartupSettingsBtn, .rowHeight = SettingsGuiValue::Settings::RowHeight });
 
     separator7.layoutComponent(sRect);
 
-    // 13. Clear Undo/Redo History Button
+    // 14. Clear Undo/Redo History Button
     auto rowClearHistoryBtns = sRect.removeFromTop(SettingsGuiValue::Settings::RowHeight);
     layoutRow({ .rowRect = rowClearHistoryBtns, .component = &clearUndoHistoryBtn, .rowHeight = SettingsGuiValue::Settings::RowHeight});
 }
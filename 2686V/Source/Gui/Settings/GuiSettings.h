@@ -118,6 +118,15 @@ class GuiSettings : public GuiBase
 
     NormalSeparator separator6;
 
+    // 同時発音数・ユニゾン上限 (プロジェクトごとに保存)
+    GuiComboBox polyphonySelector;
+    GuiComboBox unisonLimitSelector;
+    GuiComboBox renderThreadsSelector; // ボイス描画の作業スレッド数
+    GuiComboBox resampleQualitySelector; // 仮想レート → ホストのレート変換の品質
+    GuiComboBox oscAntialiasSelector; // SSG / Beep の矩形波・三角波の帯域制限
+
+    NormalSeparator separator8;
+
     // Global Settings I/O
     GuiTextButton saveSettingsBtn;
     GuiTextButton loadSettingsBtn;
@@ -195,6 +204,12 @@ public:
         separator5(context),
         virtualMidiKeyboardToggle(context),
         separator6(context),
+        polyphonySelector(context),
+        unisonLimitSelector(context),
+        renderThreadsSelector(context),
+        resampleQualitySelector(context),
+        oscAntialiasSelector(context),
+        separator8(context),
         saveSettingsBtn(context),
         loadSettingsBtn(context),
         saveStartupSettingsBtn(context),
@@ -30,4 +30,9 @@ namespace SettingsKey
 	static inline const juce::String showVirtualKeyboard = "showVirtualKeyboard";
 	static inline const juce::String fmParameterCopyType = "fmParameterCopyType";
 	static inline const juce::String fxOrder = "fxOrder";
+	static inline const juce::String polyphony = "polyphony";
+	static inline const juce::String unisonLimit = "unisonLimit";
+	static inline const juce::String renderThreads = "renderThreads";
+	static inline const juce::String resampleQuality = "resampleQuality";
+	static inline const juce::String oscAntialias = "oscAntialias";
 };
@@ -68,3 +68,11 @@ void AdpcmProcessor::processBlock(SynthParams& params, juce::AudioProcessorValue
     PrHelper::applyLp(pLp, params.adpcm.lp);
     PrHelper::applyUnison(pUnison, params.adpcm.unison);
 }
+
+QualityPcmParams AdpcmProcessor::getQuality()
+{
+    QualityPcmParams quality;
+    PrHelper::applyQualityPcm(pQuality, quality);
+
+    return quality;
+}
@@ -3,6 +3,7 @@
 #include "./ProcessorFxKeys.h"
 #include "./ProcessorFxValues.h"
 #include "./ProcessorFxNames.h"
+#include "../../Core/Processor/ProcessorHelper.h"
 
 void FxProcessor::prepare(double sampleRate)
 {
@@ -167,10 +168,19 @@ void FxProcessor::init(juce::AudioProcessorValueTreeState& apvts) {
 }
 
 void FxProcessor::processBlock(juce::AudioBuffer<float>& buffer, SynthParams& params, juce::AudioProcessorValueTreeState& apvts)
+{
+    if (!updateParameters()) return;
+
+    // エフェクト処理実行
+    effects.process(buffer);
+}
+
+bool FxProcessor::updateParameters()
 {
     if (pBypass->load(std::memory_order_relaxed) > FxPrValue::boolThread)
     {
-        return;
+        tailSeconds.store(0.0, std::memory_order_relaxed);
+        return false;
     }
 
     // Filter
@@ -247,8 +257,9 @@ void FxProcessor::processBlock(juce::AudioBuffer<float>& buffer, SynthParams& pa
     // バイパス設定
     effects.setBypasses(flB, eq3bB, tB, vB, mcB, dB, rB, scfeB);
 
-    // エフェクト処理実行
-    effects.process(buffer);
+    tailSeconds.store(effects.getTailSeconds(), std::memory_order_relaxed);
+
+    return true;
 }
 
 void FxProcessor::clear()
@@ -269,3 +280,40 @@ std::vector<int> FxProcessor::getOrder() {
 int FxProcessor::getEffectsNumber() {
     return effects.getEffectsNumber();
 }
+
+double FxProcessor::getTailSeconds() const
+{
+    return tailSeconds.load(std::memory_order_relaxed);
+}
+
+juce::uint64 FxProcessor::hashParameters(juce::uint64 seed)
+{
+    const std::atomic<float>* params[] = {
+        pBypass,
+        pFlBypass, pFlType, pFlFreq, pFlQ, pFlMix,
+        pEq3bBypass, pEq3bLowGainDb, pEq3bMidFreq, pEq3bMidGainDb, pEq3bHighGainDb, pEq3bMix,
+        pVBypass, pVRate, pVDepth, pVMix,
+        pTBypass, pTRate, pTDepth, pTMix,
+        pMbcBypass, pMbcRate, pMbcBits, pMbcMix,
+        pDBypass, pDTime, pDFb, pDMix,
+        pRBypass, pRSize, pRDamp, pRMix,
+        pSfcBypass, pSfcTime, pSfcFb,
+        pSfcFirCoef0, pSfcFirCoef1, pSfcFirCoef2, pSfcFirCoef3,
+        pSfcFirCoef4, pSfcFirCoef5, pSfcFirCoef6, pSfcFirCoef7,
+        pSfcMix,
+    };
+
+    juce::uint64 hash = seed;
+
+    for (auto* param : params) {
+        float value = param->load(std::memory_order_relaxed);
+        hash = PrHelper::hashBytes(&value, sizeof(value), hash);
+    }
+
+    // 実行順もプレビュー結果に影響する
+    for (int order : effects.getOrder()) {
+        hash = PrHelper::hashBytes(&order, sizeof(order), hash);
+    }
+
+    return hash;
+}
@@ -54,13 +54,22 @@ class FxProcessor : public PrBase
     std::atomic<float>* pSfcMix = nullptr;
 
     EffectChain effects;
+
+    // 直近のブロックで有効だったエフェクトのテール秒数 (ホストへの報告用に atomic で持つ)
+    std::atomic<double> tailSeconds{ 0.0 };
 public:
     void createLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout) override;
     void processBlock(juce::AudioBuffer<float>& buffer, SynthParams& params, juce::AudioProcessorValueTreeState& apvts);
+    // パラメータとバイパスを各エフェクトへ反映し、テールの秒数を更新する (DSP は回さない)
+    // FX 全体がバイパスなら false を返す
+    bool updateParameters();
     void prepare(double sampleRate);
     void clear();
     void init(juce::AudioProcessorValueTreeState& apvts);
     void updateOrder(const std::vector<int>& newOrders);
     std::vector<int> getOrder();
     int getEffectsNumber();
+    double getTailSeconds() const;
+    // 全 FX パラメータの現在値のハッシュ (プレビューの再描画判定用)
+    juce::uint64 hashParameters(juce::uint64 seed);
 };
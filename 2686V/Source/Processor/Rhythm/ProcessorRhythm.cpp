@@ -88,3 +88,11 @@ void RhythmProcessor::processBlock(SynthParams& params, juce::AudioProcessorValu
         PrHelper::applyFix(pFix[i], pad.fix);
     }
 }
+
+QualityPcmParams RhythmProcessor::getQuality(int padIndex)
+{
+    QualityPcmParams quality;
+    PrHelper::applyQualityPcm(pQuality[padIndex], quality);
+
+    return quality;
+}
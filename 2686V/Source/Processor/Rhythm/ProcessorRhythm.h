@@ -29,4 +29,6 @@ public:
     void createLayout(juce::AudioProcessorValueTreeState::ParameterLayout& layout) override;
     void processBlock(SynthParams& params, juce::AudioProcessorValueTreeState& apvts) override;
     void init(juce::AudioProcessorValueTreeState& apvts);
+    // サンプル読み込み時のエンコード設定 (apvts の値を直接読むのでどのスレッドからでも呼べる)
+    QualityPcmParams getQuality(int padIndex);
 };
@@ -9,10 +9,12 @@
 #include "../../Generator/Pcm/Adpcm/GenAdpcm.h"
 #include "../../Generator/Pcm/Dpcm/GenDpcm.h"
 #include "../../Generator/Pcm/Helper/GenPcmHelper.h"
+#include "../../Core/Synth/SynthFastMath.h"
 
 void AdpcmCore::prepare(double sampleRate)
 {
     m_sampleRate = sampleRate;
+    if (sampleRate > 0.0) m_outGain.prepare(sampleRate);
 
     m_phase = 0.0;
 
@@ -119,70 +121,27 @@ void AdpcmCore::setParameters(const SynthParams& params)
 }
 
 // Set sample data from external source
-void AdpcmCore::setSampleData(const std::vector<float>& sourceData, double sourceRate)
+void AdpcmCore::setSampleData(const PcmSample* sample)
 {
-    // 1. Rawデータ (32bit float) をそのまま保持
-    m_rawBuffer = sourceData;
-    m_sourceRate = sourceRate;
-
-    // 2. ADPCMデータ (4bit emulation) も事前に作っておく
-    // OPNAのレート(約16kHz)にリサンプリングして変換
-    double targetRate = 16000.0;
-
-    m_bufferSampleRate = targetRate;
-
-    m_adsr.prepare(m_bufferSampleRate);
-    m_pitchAdsr.prepare(0, m_bufferSampleRate);
-    m_ssgSwEnv.prepare(0, m_bufferSampleRate);
-    m_ssgSwEnv11.prepare(0, m_bufferSampleRate);
-    m_ssgSwPenv11.prepare(0, m_bufferSampleRate);
-
-    double step = sourceRate / targetRate;
-
-    m_pcmBuffer.clear();
-    m_pcmBuffer.reserve((size_t)(sourceData.size() / step));
-
-    double pos = 0;
-
-    // --- ロード時もDPCM/ADPCM設定に従ってエンコードする ---
-    if (m_qualityMode == dpcmMode)
-    {
-        DpcmCodec codec;
-        codec.reset();
-        while (pos < sourceData.size()) {
-            int index = (int)pos;
-
-            if (index >= sourceData.size()) break;
-
-            int16_t input = (int16_t)(sourceData[index] * 32767.0f);
-
-            m_pcmBuffer.push_back(codec.decode(codec.encode(input)));
-
-            pos += step;
-        }
+    // Rawデータ (32bit float) とエンコード結果はプロセッサ側のプールを参照するだけ
+    m_sample = sample;
+    if (m_sample == nullptr) {
+        m_encoded = nullptr;
+        m_encodePending = false;
+        return;
     }
-    else
-    {
-        Ym2608AdpcmCodec codec;
-        codec.reset();
-        while (pos < sourceData.size()) {
-            int index = (int)pos;
-
-            if (index >= sourceData.size()) break;
-
-            int16_t input = (int16_t)(sourceData[index] * 32767.0f);
 
-            m_pcmBuffer.push_back(codec.decode(codec.encode(input)));
+    m_sourceRate = m_sample->sourceRate;
+    m_encoded = nullptr; // 前のサンプルのエンコード結果は使えない
 
-            pos += step;
-        }
-    }
-
-    GenPcmHelper::lowPassFilter(m_pcmBuffer);
+    // エンコード設定はパラメータ変更時と同じ (品質・レート設定に従う)
+    refreshPcmBuffer();
 }
 
 void AdpcmCore::noteOn(float freq, float velocity, int midiNote, bool isLegato)
 {
+    if (!isLegato) m_outGain.restart();
+
     // =====================================================================
     // 1. ベロシティとベースレベルの更新 (非レガート時のみ)
     // =====================================================================
@@ -196,7 +155,7 @@ void AdpcmCore::noteOn(float freq, float velocity, int midiNote, bool isLegato)
     float rootFreq = (float)juce::MidiMessage::getMidiNoteInHertz(m_rootNote);
 
     // ADPCMモードとDPCMモードを共通で「エンコードバッファ使用モード」として判定
-    bool isEncodedMode = (m_qualityMode == adpcmMode || m_qualityMode == dpcmMode);
+    bool isEncodedMode = (m_playMode == adpcmMode || m_playMode == dpcmMode);
     double currentBufferRate = isEncodedMode ? m_bufferSampleRate : m_sourceRate;
     float finalFreq = freq;
 
@@ -390,14 +349,15 @@ float AdpcmCore::getSample()
     }
 
     float output = 0.0f;
-    bool isEncodedMode = (m_qualityMode == adpcmMode || m_qualityMode == dpcmMode);
+    bool isEncodedMode = (m_playMode == adpcmMode || m_playMode == dpcmMode);
     double currentBufferRate = m_sampleRate;
 
     // ノイズを出すために、バッファが空でも最後まで通す
-    if (isEncodedMode && !m_pcmBuffer.empty()) {
+    if (isEncodedMode && m_encoded != nullptr && !m_encoded->data.empty()) {
         if (m_hasFinished) return 0.0f;
 
-        size_t totalSize = m_pcmBuffer.size();
+        const auto& pcmBuffer = m_encoded->data;
+        size_t totalSize = pcmBuffer.size();
 
         currentBufferRate = m_bufferSampleRate;
 
@@ -486,10 +446,10 @@ float AdpcmCore::getSample()
         float s_m1, s_0, s_1, s_2;
 
         // エンコードバッファ (int16_t) から読み込み、正規化
-        s_m1 = m_pcmBuffer[idx_m1] / 32768.0f;
-        s_0 = m_pcmBuffer[idx_0] / 32768.0f;
-        s_1 = m_pcmBuffer[idx_1] / 32768.0f;
-        s_2 = m_pcmBuffer[idx_2] / 32768.0f;
+        s_m1 = pcmBuffer[idx_m1] / 32768.0f;
+        s_0 = pcmBuffer[idx_0] / 32768.0f;
+        s_1 = pcmBuffer[idx_1] / 32768.0f;
+        s_2 = pcmBuffer[idx_2] / 32768.0f;
 
         // =========================================================
         // 補間処理 (Interpolation)
@@ -542,10 +502,11 @@ float AdpcmCore::getSample()
         }
         }
     }
-    else if (!isEncodedMode && !m_rawBuffer.empty()) {
+    else if (!isEncodedMode && m_sample != nullptr && !m_sample->raw.empty()) {
         if (m_hasFinished) return 0.0f;
 
-        size_t totalSize = m_rawBuffer.size();
+        const auto& rawBuffer = m_sample->raw;
+        size_t totalSize = rawBuffer.size();
 
         currentBufferRate = m_sourceRate;
 
@@ -634,10 +595,10 @@ float AdpcmCore::getSample()
         float s_m1, s_0, s_1, s_2;
 
         // Rawバッファから読み込み
-        s_m1 = m_rawBuffer[idx_m1];
-        s_0 = m_rawBuffer[idx_0];
-        s_1 = m_rawBuffer[idx_1];
-        s_2 = m_rawBuffer[idx_2];
+        s_m1 = rawBuffer[idx_m1];
+        s_0 = rawBuffer[idx_0];
+        s_1 = rawBuffer[idx_1];
+        s_2 = rawBuffer[idx_2];
 
         // =========================================================
         // 補間処理 (Interpolation)
@@ -691,7 +652,7 @@ float AdpcmCore::getSample()
         }
 
         // Raw/BitCrusher モード時のビットリダクション
-        output = GenPcmHelper::bitReduction(output, m_qualityMode);
+        output = GenPcmHelper::bitReduction(output, m_playMode);
     }
 
     // ==========================================
@@ -705,7 +666,7 @@ float AdpcmCore::getSample()
     if (m_lfo.am.enable) {
         // depthDb はセットアップ時に計算済みなので、そのままdB減衰に変換
         float attenDb = m_lfo.value.am * m_lfo.am.depthDb;
-        amMultiplier = std::pow(10.0f, -attenDb / 20.0f);
+        amMultiplier = FastMath::dbToGain(-attenDb);
     }
 
     // 2. Pitch Modulation (PM / 音程)
@@ -717,7 +678,7 @@ float AdpcmCore::getSample()
     }
 
     // セントを周波数倍率(レシオ)に変換
-    float opzx7PitchMod = std::pow(2.0f, pitchModCents / 1200.0f);
+    float opzx7PitchMod = FastMath::centsToRatio(pitchModCents);
     float mwPitchMod = 1.0f + (m_lfo.value.pm * (m_modWheel * 0.03f));
     double currentIncrement = m_pitchAdsr.process(m_pitchRatio * m_pitchBendRatio * mwPitchMod);
     currentIncrement = m_ssgSwPenv11.process(currentIncrement);
@@ -743,83 +704,88 @@ float AdpcmCore::getSample()
     float noiseGain = m_mix;
     float rawMixed = (output * m_tone * toneGain * 4.0f) + m_noiseGen.generateSample(noiseGain) * 0.4f;
 
-    return rawMixed * m_level * finalEnv * m_baseLevel * amMultiplier;
+    return rawMixed * finalEnv * m_baseLevel * amMultiplier;
 }
 
 void AdpcmCore::refreshPcmBuffer()
 {
-    if (m_rawBuffer.empty()) return;
+    if (m_sample == nullptr || m_sample->raw.empty()) return;
 
     double targetRate = getTargetRate(m_rateIndex, 16000.0f);
 
     // Do not upsample beyond source rate for the ADPCM buffer gen
-    if (targetRate > m_sourceRate) targetRate = m_sourceRate;
-
-    m_bufferSampleRate = targetRate;
-
-    m_adsr.prepare(m_bufferSampleRate);
-    m_pitchAdsr.prepare(0, m_bufferSampleRate);
-    m_ssgSwEnv.prepare(0, m_bufferSampleRate);
-    m_ssgSwEnv11.prepare(0, m_bufferSampleRate);
-    m_ssgSwPenv11.prepare(0, m_bufferSampleRate);
-    m_noiseGen.prepare(m_bufferSampleRate);
+    double bufferRate = GenPcmPool::getEncodedRate(*m_sample, targetRate);
 
-    // Resample & Encode
-    double step = m_sourceRate / targetRate;
-    if (step <= 0.0) step = 1.0;
-
-    m_pcmBuffer.clear();
-    m_pcmBuffer.reserve((size_t)(m_rawBuffer.size() / step) + 1);
-
-    double pos = 0;
-
-    // --- DPCMとADPCMの分岐エンコード ---
-    if (m_qualityMode == dpcmMode)
-    {
-        DpcmCodec codec;
-        codec.reset();
+    // Raw再生モードではエンコードバッファを使わないので、すぐに切り替える
+    if (m_qualityMode != adpcmMode && m_qualityMode != dpcmMode) {
+        m_encodePending = false;
+        applyPcmBuffer(m_qualityMode, bufferRate, nullptr);
+        return;
+    }
 
-        while (pos < m_rawBuffer.size()) {
-            int index = (int)pos;
+    // エンコードはプールのスレッドが行うので、ここでは作成済みのバッファを探すだけ
+    // まだ無ければ、出来上がるまで今のバッファ (レート・エンベロープもそのまま) で鳴らし続け、renderNextBlock で拾って切り替える
+    // (このサンプルで鳴らせるバッファがまだ何も無い時だけ、無音で待つ)
+    m_pendingBufferRate = bufferRate;
 
-            if (index >= m_rawBuffer.size()) break;
+    if (auto* encoded = m_sample->findEncoded(m_qualityMode, bufferRate)) {
+        m_encodePending = false;
+        applyPcmBuffer(m_qualityMode, bufferRate, encoded);
+        return;
+    }
 
-            int16_t input = (int16_t)(m_rawBuffer[index] * 32767.0f);
+    m_encodePending = true;
 
-            m_pcmBuffer.push_back(codec.decode(codec.encode(input)));
+    const bool isPlayable = (m_playMode != adpcmMode && m_playMode != dpcmMode) || m_encoded != nullptr;
+    if (!isPlayable) applyPcmBuffer(m_qualityMode, bufferRate, nullptr);
+}
 
-            pos += step;
-        }
+void AdpcmCore::applyPcmBuffer(int mode, double bufferRate, const PcmEncoded* encoded)
+{
+    auto getPlayRate = [this] {
+        return (m_playMode == adpcmMode || m_playMode == dpcmMode) ? m_bufferSampleRate : m_sourceRate;
+    };
+
+    const double oldRate = getPlayRate();
+
+    m_playMode = mode;
+    m_encoded = encoded;
+    m_bufferSampleRate = bufferRate;
+
+    // 発音中でも途切れないよう、再生位置と再生速度を新しいバッファのレートに合わせる
+    const double newRate = getPlayRate();
+    if (oldRate > 0.0 && newRate != oldRate) {
+        const double scale = newRate / oldRate;
+        m_position *= scale;
+        m_pitchRatio = (float)(m_pitchRatio * scale);
     }
-    else
-    {
-        Ym2608AdpcmCodec codec;
-        codec.reset();
-
-        while (pos < m_rawBuffer.size()) {
-            int index = (int)pos;
-
-            if (index >= m_rawBuffer.size()) break;
 
-            int16_t input = (int16_t)(m_rawBuffer[index] * 32767.0f);
+    m_adsr.prepare(m_bufferSampleRate);
+    m_pitchAdsr.prepare(0, m_bufferSampleRate);
+    m_ssgSwEnv.prepare(0, m_bufferSampleRate);
+    m_ssgSwEnv11.prepare(0, m_bufferSampleRate);
+    m_ssgSwPenv11.prepare(0, m_bufferSampleRate);
+    m_noiseGen.prepare(m_bufferSampleRate);
+}
 
-            m_pcmBuffer.push_back(codec.decode(codec.encode(input)));
+void AdpcmCore::pollEncoded()
+{
+    if (!m_encodePending || m_sample == nullptr) return;
 
-            pos += step;
-        }
+    // 出来上がった時に、バッファ・レート・エンベロープをまとめて切り替える
+    if (auto* encoded = m_sample->findEncoded(m_qualityMode, m_pendingBufferRate)) {
+        m_encodePending = false;
+        applyPcmBuffer(m_qualityMode, m_pendingBufferRate, encoded);
     }
-
-    GenPcmHelper::lowPassFilter(m_pcmBuffer);
 }
 
-void AdpcmCore::renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive)
+void AdpcmCore::renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive)
 {
-    float sample = getSample();
-    float pan = getCurrentPan();
-
+    // パン・ユニゾン補正の目標値はブロックごとに1回だけ計算し、ブロック内ではサンプル単位で補間する
     // ユニゾン・ハーモニー向けに変更
     float basePanL = m_panL;
     float basePanR = m_panR;
+    float gainComp = 1.0f;
 
     if (m_unisonTotal > 1) {
         float spreadPos = ((float)m_unisonIndex / (float)(m_unisonTotal - 1)) * 2.0f - 1.0f; // -1.0 to 1.0
@@ -832,17 +798,33 @@ void AdpcmCore::renderNextBlock(float* outR, float* outL, int startSample, int s
 
         // 音量補正 (ボイス数が増えると爆音になるため下げる)
         // ルートを取るか、単純に割るかは好みですが、単純割りの方が安全です
-        float gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
-        sample *= gainComp;
+        gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
     }
 
-    outL[startSample + sampleIdx] += sample * basePanL;
-    outR[startSample + sampleIdx] += sample * basePanR;
+    // レベルもここで掛ける (ブロック境界でゲインが段差にならないよう、目標値へ向けてなめらかに動かす)
+    m_outGain.setTarget(basePanL * gainComp * m_level, basePanR * gainComp * m_level);
+
+    pollEncoded();
 
-    isActive = isPlaying();
+    isActive = true;
+
+    for (int i = startSample; i < startSample + numSamples; ++i)
+    {
+        float sample = getSample();
+
+        outL[i] += sample * m_outGain.left.getNextValue();
+        outR[i] += sample * m_outGain.right.getNextValue();
+
+        if (!isPlaying())
+        {
+            isActive = false;
+            break;
+        }
+    }
 }
 
 void AdpcmCore::clearBuffer() {
-    m_pcmBuffer.clear();
-    m_rawBuffer.clear();
+    m_encoded = nullptr;
+    m_encodePending = false;
+    m_sample = nullptr;
 }
@@ -4,6 +4,7 @@
 
 #include "../../Core/Synth/SynthParams.h"
 #include "../../Core/Synth/SynthCore.h"
+#include "../../Core/Synth/SynthSmoother.h"
 #include "../../Effect/Envelope/Amp/Adsr/EnvAmpAdsr.h"
 #include "../../Effect/Envelope/Pitch/Adsr/EnvPirchAdsr.h"
 #include "../../Effect/Envelope/Amp/SsgSw/EnvSsgSw.h"
@@ -14,10 +15,11 @@
 #include "../../Advanced/Curve/AdvancedCurve.h"
 #include "../../Generator/Fm/Fix/FmFix.h"
 #include "../../Generator/Noise/Ssg/GenNoiseSsg.h"
+#include "../../Generator/Pcm/Pool/GenPcmPool.h"
 
 // --- Core Class ---
 
-class AdpcmCore : public SynthCore
+class AdpcmCore final : public SynthCore
 {
 public:
     AdpcmCore(): SynthCore() {}
@@ -25,7 +27,7 @@ public:
     void prepare(double sampleRate) override;
 	void setSampleRate(double sampleRate) override;
     void setParameters(const SynthParams& params) override;
-    void setSampleData(const std::vector<float>& sourceData, double sourceRate);
+    void setSampleData(const PcmSample* sample);
     void noteOn(float freq, float velocity, int midiNote, bool isLegato = false) override;
     void noteOff() override;
     bool isPlaying() const override;
@@ -34,7 +36,7 @@ public:
     float getCurrentPan() const;
     void setPitchBendRatio(float ratio) override;
     float getSample() override;
-    void renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive) override;
+    void renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive) override;
     void setCurveCore(CurveCore* p_curveCore);
     void clearBuffer();
 
@@ -55,9 +57,12 @@ private:
     double m_bufferSampleRate = 16000.0; // Internal Data Sample Rate
 
     // Processed ADPCM Data (stored as int16 for playback)
-    std::vector<float> m_rawBuffer;     // Raw Data (32bit)
-    std::vector<int16_t> m_pcmBuffer;   // Processed Data (4bit ADPCM/DPCM)
+    const PcmSample* m_sample = nullptr;      // Raw Data (32bit, プロセッサが所有)
+    const PcmEncoded* m_encoded = nullptr; // Processed Data (4bit ADPCM/DPCM, プールのスレッドが作成)
+    bool m_encodePending = false;          // 現在の設定のエンコード完了待ち (その間は前のバッファで鳴らす)
+    double m_pendingBufferRate = 16000.0;  // 完了待ちのエンコードのレート
     int m_qualityMode = 6;
+    int m_playMode = 6; // 今鳴らしているバッファのモード (エンコード完了待ちの間は前の設定のまま)
     int m_rateIndex = 3;
     int m_interpolationMode = 1;
     double m_targetRate = 44100.0;
@@ -69,6 +74,7 @@ private:
 
     // Params
     float m_level = 1.0f;
+    StereoGainSmoother m_outGain; // レベル・パンはここでサンプル単位に補間して掛ける
     float m_pan = 0.5f;
 	float m_panL = 1.0f;
 	float m_panR = 1.0f;
@@ -107,6 +113,9 @@ private:
     float m_modWheel = 0.0f;
 
     void refreshPcmBuffer();
+    // 鳴らすバッファを切り替える (モード・レートとそれに合わせたエンベロープ・ノイズのレートをまとめて)
+    void applyPcmBuffer(int mode, double bufferRate, const PcmEncoded* encoded);
+    void pollEncoded(); // エンコード完了待ちならプールの結果を拾う (オーディオスレッド)
 
     // ユニゾン・ハーモニー用
     bool m_isMonoMode = false;
@@ -1,9 +1,13 @@
 ﻿#include <JuceHeader.h>
 
 #include "./SynthBeep.h"
+#include "../../Core/Synth/SynthFastMath.h"
 
 void BeepCore::prepare(double sampleRate) {
-    if (sampleRate > 0.0) m_sampleRate = sampleRate;
+    if (sampleRate > 0.0) {
+        m_sampleRate = sampleRate;
+        m_outGain.prepare(sampleRate);
+    }
 
 	m_adsr.prepare(44100.0);
     m_pitchAdsr.prepare(0, 44100.0);
@@ -35,6 +39,7 @@ void BeepCore::setSampleRate(double sampleRate) {
 
 void BeepCore::setParameters(const SynthParams& params) {
     m_level = params.beep.level;
+    m_antialias = params.oscAntialias;
 
     // ユニゾン・ハーモニー用
     m_isMonoMode = params.monoMode;
@@ -52,6 +57,8 @@ void BeepCore::setParameters(const SynthParams& params) {
 }
 
 void BeepCore::noteOn(float freq, float velocity, int midiNote, bool isLegato) {
+    if (!isLegato) m_outGain.restart();
+
     // =====================================================================
     // モノフォニック・レガート時は、音量（ベロシティ）を更新しない！
     // 1音目の音量をそのまま引き継ぐことで、音量ジャンプを完全に防ぐ。
@@ -236,7 +243,7 @@ float BeepCore::getSample() {
     if (m_lfo.am.enable) {
         // depthDb はセットアップ時に計算済みなので、そのままdB減衰に変換
         float attenDb = m_lfo.value.am * m_lfo.am.depthDb;
-        amMultiplier = std::pow(10.0f, -attenDb / 20.0f);
+        amMultiplier = FastMath::dbToGain(-attenDb);
     }
 
     // 2. Pitch Modulation (PM / 音程)
@@ -248,7 +255,7 @@ float BeepCore::getSample() {
     }
 
     // セントを周波数倍率(レシオ)に変換
-    float opzx7PitchMod = std::pow(2.0f, pitchModCents / 1200.0f);
+    float opzx7PitchMod = FastMath::centsToRatio(pitchModCents);
 
     float modDepth = m_modWheel * 0.03f;
     float mwPitchMod = 1.0f + (m_lfo.value.pm * modDepth);
@@ -263,12 +270,17 @@ float BeepCore::getSample() {
 
     phaseInc = newPhaseDelta * freqMult;
 
+    if (m_antialias && phaseInc < 0.5f) {
+        // 立ち上がり (位相 0) と立ち下がり (位相 0.5) の段差をならす
+        output += 2.0f * (PolyBlep::step(m_phase, phaseInc) - PolyBlep::step(PolyBlep::wrap(m_phase - 0.5f), phaseInc));
+    }
+
     m_phase += phaseInc;
 
     if (m_phase >= 1.0f) m_phase -= 1.0f;
 
     // 音量に変換
-    return output * finalEnv * m_baseLevel * m_level * amMultiplier;
+    return output * finalEnv * m_baseLevel * amMultiplier;
 }
 
 // モジュレーションホイール (0 - 127)
@@ -283,13 +295,13 @@ void BeepCore::setPitchBendRatio(float ratio)
     m_pitchBendRatio = ratio;
 }
 
-void BeepCore::renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive)
+void BeepCore::renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive)
 {
-    float sample = getSample();
-
+    // パン・ユニゾン補正の目標値はブロックごとに1回だけ計算し、ブロック内ではサンプル単位で補間する
     // ユニゾン・ハーモニー向けに変更
     float basePanL = 1.0f;
     float basePanR = 1.0f;
+    float gainComp = 1.0f;
 
     if (m_unisonTotal > 1) {
         float spreadPos = ((float)m_unisonIndex / (float)(m_unisonTotal - 1)) * 2.0f - 1.0f; // -1.0 to 1.0
@@ -302,12 +314,25 @@ void BeepCore::renderNextBlock(float* outR, float* outL, int startSample, int sa
 
         // 音量補正 (ボイス数が増えると爆音になるため下げる)
         // ルートを取るか、単純に割るかは好みですが、単純割りの方が安全です
-        float gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
-        sample *= gainComp;
+        gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
     }
 
-    outL[startSample + sampleIdx] += sample * basePanL;
-    outR[startSample + sampleIdx] += sample * basePanR;
+    // レベルもここで掛ける (ブロック境界でゲインが段差にならないよう、目標値へ向けてなめらかに動かす)
+    m_outGain.setTarget(basePanL * gainComp * m_level, basePanR * gainComp * m_level);
 
-    isActive = isPlaying();
+    isActive = true;
+
+    for (int i = startSample; i < startSample + numSamples; ++i)
+    {
+        float sample = getSample();
+
+        outL[i] += sample * m_outGain.left.getNextValue();
+        outR[i] += sample * m_outGain.right.getNextValue();
+
+        if (!isPlaying())
+        {
+            isActive = false;
+            break;
+        }
+    }
 }
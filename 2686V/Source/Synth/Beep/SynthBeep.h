@@ -4,6 +4,7 @@
 
 #include "../../Core/Synth/SynthParams.h"
 #include "../../Core/Synth/SynthCore.h"
+#include "../../Core/Synth/SynthSmoother.h"
 #include "../../Effect/Envelope/Amp/Adsr/EnvAmpAdsr.h"
 #include "../../Effect/Envelope/Pitch/Adsr/EnvPirchAdsr.h"
 #include "../../Effect/Envelope/Amp/SsgSw/EnvSsgSw.h"
@@ -11,10 +12,11 @@
 #include "../../Effect/Envelope/Pitch/SsgSw11/EnvSsgSw11.h"
 #include "../../Effect/Detune/Opzx7/DetuneOpzx7.h"
 #include "../../Generator/Fm/Fix/FmFix.h"
+#include "../../Generator/Blep/GenBlep.h"
 #include "../../Advanced/Curve/AdvancedCurve.h"
 #include "../../Effect/Lfo/Opzx7/LfoOpzx7.h"
 
-class BeepCore : public SynthCore
+class BeepCore final : public SynthCore
 {
 public:
     BeepCore() : SynthCore() {}
@@ -29,7 +31,7 @@ public:
     void setModulationWheel(int wheelValue) override;
     void setPitchBendRatio(float ratio) override;
     float getSample() override;
-    void renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive) override;
+    void renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive) override;
     void setCurveCore(CurveCore* p_curveCore);
 
     // ユニゾン・ハーモニー用
@@ -57,6 +59,8 @@ private:
 
     // Params
     float m_level = 1.0f;
+    StereoGainSmoother m_outGain; // レベル・パンはここでサンプル単位に補間して掛ける
+    bool m_antialias = false; // 矩形波の段差を PolyBLEP でならす (設定画面の値)
 
     AmpAdsrEnv m_adsr;
     FixMode m_fixMode;
@@ -42,7 +42,11 @@ const std::array<OplCore::AlgRouting, OplPrValue::algorithms> OplCore::routings
 } };
 
 void OplCore::prepare(double sampleRate) {
-    if (sampleRate > 0.0) m_hostSampleRate = sampleRate;
+    if (sampleRate > 0.0) {
+        m_hostSampleRate = sampleRate;
+        m_outGain.prepare(sampleRate);
+    }
+    m_resampler.prepare();
 
     double target = getTargetRate(m_rateIndex);
 
@@ -68,6 +72,7 @@ void OplCore::setSampleRate(double sampleRate) {
 
 void OplCore::setParameters(const SynthParams& params) {
     m_level = params.opl.level;
+    m_resampleQuality = params.resampleQuality;
 
     m_algorithm = params.opl.algFb.algorithm; // 0:Serial(FM), 1:Parallel(AM)
 
@@ -98,6 +103,8 @@ void OplCore::setParameters(const SynthParams& params) {
 }
 
 void OplCore::noteOn(float freq, float velocity, int midiNote, bool isLegato) {
+    if (!isLegato) m_outGain.restart();
+
     // ※トランペット系の音が歪む課題に対応した、かなりな力技
     // 通常のvelocityでは1.0に近くなると音が歪むため、0.25倍して十分な余裕を持たせます。最低値は0.01にして完全な無音を防止します。
     float gain = std::max(0.01f, velocity * 0.25f);
@@ -220,22 +227,27 @@ float OplCore::getSample() {
         finalOut *= 2.0f; // ゲイン補正
 
         m_lastSample = finalOut;
+
+        m_resampler.push(m_lastSample);
     }
 
+    // 帯域制限した補間 (品質が Linear の時は従来の直線補間)
+    if (m_resampler.isBandLimited()) return m_resampler.read(m_rateAccumulator);
+
     float fraction = (float)(m_rateAccumulator / stepSize);
 
     if (fraction > 1.0f) fraction = 1.0f;
 
-    return (m_prevSample + (m_lastSample - m_prevSample) * fraction * 2.0f) * m_level;
+    return m_prevSample + (m_lastSample - m_prevSample) * fraction * 2.0f;
 }
 
-void OplCore::renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive)
+void OplCore::renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive)
 {
-    float sample = getSample();
-
+    // パン・ユニゾン補正の目標値はブロックごとに1回だけ計算し、ブロック内ではサンプル単位で補間する
     // ユニゾン・ハーモニー向けに変更
     float basePanL = 1.0f;
     float basePanR = 1.0f;
+    float gainComp = 1.0f;
 
     if (m_unisonTotal > 1) {
         float spreadPos = ((float)m_unisonIndex / (float)(m_unisonTotal - 1)) * 2.0f - 1.0f; // -1.0 to 1.0
@@ -248,14 +260,30 @@ void OplCore::renderNextBlock(float* outR, float* outL, int startSample, int sam
 
         // 音量補正 (ボイス数が増えると爆音になるため下げる)
         // ルートを取るか、単純に割るかは好みですが、単純割りの方が安全です
-        float gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
-        sample *= gainComp;
+        gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
     }
 
-    outL[startSample + sampleIdx] += sample * basePanL;
-    outR[startSample + sampleIdx] += sample * basePanR;
+    // レベルもここで掛ける (ブロック境界でゲインが段差にならないよう、目標値へ向けてなめらかに動かす)
+    m_outGain.setTarget(basePanL * gainComp * m_level, basePanR * gainComp * m_level);
 
-    isActive = isPlaying();
+    isActive = true;
+
+    // レート・品質が変わった時だけ変換の設定を作り直す
+    m_resampler.configure(getTargetRate(m_rateIndex), m_hostSampleRate, m_resampleQuality);
+
+    for (int i = startSample; i < startSample + numSamples; ++i)
+    {
+        float sample = getSample();
+
+        outL[i] += sample * m_outGain.left.getNextValue();
+        outR[i] += sample * m_outGain.right.getNextValue();
+
+        if (!isPlaying())
+        {
+            isActive = false;
+            break;
+        }
+    }
 }
 
 void OplCore::updateRoutingCache()
@@ -1,6 +1,8 @@
 ﻿#pragma once
 
 #include "../../Core/Fm/FmCore.h"
+#include "../../Core/Synth/SynthSmoother.h"
+#include "../../Core/Synth/SynthResampler.h"
 #include "../../Advanced/Curve/AdvancedCurve.h"
 #include "../../Processor/Opl/ProcessorOplValues.h"
 
@@ -10,7 +12,7 @@
 // OPL (YM3526/3812) Core
 // Features: 2 Operators, 2 Algorithms (FM/AM), Wave Select
 // ==========================================================
-class OplCore : public FmCore
+class OplCore final : public FmCore
 {
 public:
     OplCore() : FmCore() {}
@@ -24,7 +26,7 @@ public:
     void setPitchBend(int pitchWheelValue) override;
     void setModulationWheel(int wheelValue) override;
     float getSample() override;
-    void renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive) override;
+    void renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive) override;
     void setCurveCore(CurveCore* p_curveCore);
 
     // ユニゾン・ハーモニー用
@@ -84,11 +86,14 @@ private:
     void updateRoutingCache();
 
     float m_level = 1.0f;
+    StereoGainSmoother m_outGain; // レベル・パンはここでサンプル単位に補間して掛ける
 
     int m_algorithm = 0;
     double m_hostSampleRate = 44100.0;
     int m_rateIndex = 1;
     double m_rateAccumulator = 0.0;
+    VirtualRateResampler m_resampler; // 仮想レートからホストのレートへの変換 (品質が Linear 以外の時)
+    int m_resampleQuality = VirtualRateResampler::Standard;
     float m_lastSample = 0.0f;
     float m_prevSample = 0.0f;
     float m_quantizeSteps = 0.0f;
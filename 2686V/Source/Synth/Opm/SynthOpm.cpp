@@ -48,7 +48,11 @@ const std::array<OpmCore::AlgRouting, OpmPrValue::algorithms> OpmCore::routings
 } };
 
 void OpmCore::prepare(double sampleRate) {
-    if (sampleRate > 0.0) m_hostSampleRate = sampleRate;
+    if (sampleRate > 0.0) {
+        m_hostSampleRate = sampleRate;
+        m_outGain.prepare(sampleRate);
+    }
+    m_resampler.prepare();
 
     double target = getTargetRate(m_rateIndex);
 
@@ -81,6 +85,7 @@ void OpmCore::setSampleRate(double sampleRate) {
 
 void OpmCore::setParameters(const SynthParams& params) {
     m_level = params.opm.level;
+    m_resampleQuality = params.resampleQuality;
 
     m_algorithm = params.opm.algFb.algorithm;
 
@@ -140,6 +145,8 @@ void OpmCore::setParameters(const SynthParams& params) {
 }
 
 void OpmCore::noteOn(float freq, float velocity, int midiNote, bool isLegato) {
+    if (!isLegato) m_outGain.restart();
+
     int noteNum = (int)(69.0 + 12.0 * std::log2(freq / 440.0));
     float gain = std::max(0.01f, velocity * 0.25f);
 
@@ -269,22 +276,27 @@ float OpmCore::getSample() {
         finalOut *= 2.0f; // ゲイン補正
 
         m_lastSample = finalOut;
+
+        m_resampler.push(m_lastSample);
     }
 
+    // 帯域制限した補間 (品質が Linear の時は従来の直線補間)
+    if (m_resampler.isBandLimited()) return m_resampler.read(m_rateAccumulator);
+
     float fraction = (float)(m_rateAccumulator / stepSize);
 
     if (fraction > 1.0f) fraction = 1.0f;
 
-    return (m_prevSample + (m_lastSample - m_prevSample) * fraction) * m_level;
+    return m_prevSample + (m_lastSample - m_prevSample) * fraction;
 }
 
-void OpmCore::renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive)
+void OpmCore::renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive)
 {
-    float sample = getSample();
-
+    // パン・ユニゾン補正の目標値はブロックごとに1回だけ計算し、ブロック内ではサンプル単位で補間する
     // ユニゾン・ハーモニー向けに変更
     float basePanL = m_pan_l_rate;
     float basePanR = m_pan_r_rate;
+    float gainComp = 1.0f;
 
     if (m_unisonTotal > 1) {
         float spreadPos = ((float)m_unisonIndex / (float)(m_unisonTotal - 1)) * 2.0f - 1.0f; // -1.0 to 1.0
@@ -297,14 +309,30 @@ void OpmCore::renderNextBlock(float* outR, float* outL, int startSample, int sam
 
         // 音量補正 (ボイス数が増えると爆音になるため下げる)
         // ルートを取るか、単純に割るかは好みですが、単純割りの方が安全です
-        float gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
-        sample *= gainComp;
+        gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
     }
 
-    outL[startSample + sampleIdx] += sample * basePanL;
-    outR[startSample + sampleIdx] += sample * basePanR;
+    // レベルもここで掛ける (ブロック境界でゲインが段差にならないよう、目標値へ向けてなめらかに動かす)
+    m_outGain.setTarget(basePanL * gainComp * m_level, basePanR * gainComp * m_level);
 
-    isActive = isPlaying();
+    isActive = true;
+
+    // レート・品質が変わった時だけ変換の設定を作り直す
+    m_resampler.configure(getTargetRate(m_rateIndex), m_hostSampleRate, m_resampleQuality);
+
+    for (int i = startSample; i < startSample + numSamples; ++i)
+    {
+        float sample = getSample();
+
+        outL[i] += sample * m_outGain.left.getNextValue();
+        outR[i] += sample * m_outGain.right.getNextValue();
+
+        if (!isPlaying())
+        {
+            isActive = false;
+            break;
+        }
+    }
 }
 
 void OpmCore::updateRoutingCache()
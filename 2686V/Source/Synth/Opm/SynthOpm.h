@@ -3,6 +3,8 @@
 #include <random>
 
 #include "../../Core/Fm/FmCore.h"
+#include "../../Core/Synth/SynthSmoother.h"
+#include "../../Core/Synth/SynthResampler.h"
 #include "../../Generator/Noise/Lfsr/GenNoiseLfsr.h"
 #include "../../Effect/Lfo/Opm/LfoOpm.h"
 #include "../../Advanced/Curve/AdvancedCurve.h"
@@ -10,7 +12,7 @@
 
 #include "./Operator/SynthOpmOp.h"
 
-class OpmCore : public FmCore
+class OpmCore final : public FmCore
 {
 public:
     OpmCore() : FmCore() {}
@@ -23,7 +25,7 @@ public:
     void setPitchBend(int pitchWheelValue) override;
     void setModulationWheel(int wheelValue) override;
     float getSample() override;
-    void renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive) override;
+    void renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive) override;
     void setCurveCore(CurveCore* p_curveCore);
 
     // ユニゾン・ハーモニー用
@@ -86,6 +88,7 @@ private:
     void updateRoutingCache();
 
     float m_level = 1.0f;
+    StereoGainSmoother m_outGain; // レベル・パンはここでサンプル単位に補間して掛ける
 
     double m_hostSampleRate = 44100.0;
     int m_algorithm = 0;
@@ -93,6 +96,8 @@ private:
     // Rate & Quality
     int m_rateIndex = 1;
     double m_rateAccumulator = 0.0;
+    VirtualRateResampler m_resampler; // 仮想レートからホストのレートへの変換 (品質が Linear 以外の時)
+    int m_resampleQuality = VirtualRateResampler::Standard;
     float m_lastSample = 0.0f;
     float m_prevSample = 0.0f;
     float m_quantizeSteps = 0.0f;
@@ -1,5 +1,6 @@
 ﻿#include "./SynthOpnOp.h"
 #include "../../../Core/Processor/ProcessorValues.h"
+#include "../../../Core/Synth/SynthFastMath.h"
 
 void OpnOperator::prepare(int opIndex, double sampleRate) {
     m_ampAdsr.prepare(opIndex, sampleRate);
@@ -239,7 +240,7 @@ void OpnOperator::getSample(float& output, float modulator, float feedbackModula
         float attenuationDb = unipolarLfo * (n88Lfo.depthDb * this->m_ams) * maxAmDepthDb;
 
         // デシベルをリニアな音量倍率に変換
-        totalAmpMod = std::pow(10.0f, -attenuationDb / 20.0f);
+        totalAmpMod = FastMath::dbToGain(-attenuationDb);
     }
 
     // 両方のAMをエンベロープに適用
@@ -257,12 +258,12 @@ void OpnOperator::getSample(float& output, float modulator, float feedbackModula
         // 最大で ±1オクターブ (1200セント) の揺れ幅と定義する
         // pmLfoVal は -1.0 ~ 1.0
         // セント値を周波数の倍率に変換 (2 ^ (cent / 1200))
-        lfoPitchMod = std::pow(2.0f, (n88Lfo.value.pm * n88Lfo.depthNorm * 1200.0f) / 1200.0f);
+        lfoPitchMod = FastMath::centsToRatio(n88Lfo.value.pm * n88Lfo.depthNorm * 1200.0f);
     }
 
     // ③ モジュレーションホイール (Global LFO を使う)
     float wheelCent = n88Lfo.value.pm * (modWheel * 200.0f);
-    lfoPitchMod *= std::pow(2.0f, wheelCent / 1200.0f);
+    lfoPitchMod *= FastMath::centsToRatio(wheelCent);
 
     // ========================================================
     // 3. 位相と波形の生成
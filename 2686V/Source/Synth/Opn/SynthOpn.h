@@ -1,6 +1,8 @@
 ﻿#pragma once
 
 #include "../../Core/Fm/FmCore.h"
+#include "../../Core/Synth/SynthSmoother.h"
+#include "../../Core/Synth/SynthResampler.h"
 #include "../../Generator/Noise/Lfsr/GenNoiseLfsr.h"
 #include "../../Effect/Lfo/N88/LfoN88.h"
 #include "../../Advanced/Curve/AdvancedCurve.h"
@@ -12,7 +14,7 @@
 // OPN (YM2203) Core
 // Features: 4 Operators, 8 Algorithms, No SSG-EG, No HW LFO
 // ==========================================================
-class OpnCore : public FmCore
+class OpnCore final : public FmCore
 {
 public:
     OpnCore() : FmCore() {}
@@ -26,7 +28,7 @@ public:
     void setPitchBend(int pitchWheelValue) override;
     void setModulationWheel(int wheelValue) override;
     float getSample() override;
-    void renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive) override;
+    void renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive) override;
     void setCurveCore(CurveCore* p_curveCore);
 
     // ユニゾン・ハーモニー用
@@ -89,11 +91,14 @@ private:
     void updateRoutingCache();
 
     float m_level = 1.0f;
+    StereoGainSmoother m_outGain; // レベル・パンはここでサンプル単位に補間して掛ける
 
     int m_algorithm = 0;
     double m_hostSampleRate = 44100.0;
     int m_rateIndex = 1;
     double m_rateAccumulator = 0.0;
+    VirtualRateResampler m_resampler; // 仮想レートからホストのレートへの変換 (品質が Linear 以外の時)
+    int m_resampleQuality = VirtualRateResampler::Standard;
     float m_lastSample = 0.0f;
     float m_prevSample = 0.0f;
     float m_quantizeSteps = 0.0f;
@@ -1,5 +1,6 @@
 ﻿#include "./SynthOpzx7Op.h"
 #include "../../../Core/Processor/ProcessorValues.h"
+#include "../../../Core/Synth/SynthFastMath.h"
 
 void Opzx7Operator::prepare(int opIndex, double sampleRate) {
     m_ampAdsr.prepare(opIndex, sampleRate);
@@ -353,11 +354,11 @@ void Opzx7Operator::getSample(float& output, float modulator, float feedbackModu
 
     // ① グローバルAM (最大 96dB の減衰)
     if (glLfo.am.enable) {
-        totalAmpMod *= std::pow(10.0f, -(glLfo.value.am * glLfo.am.depthDb) / 20.0f);
+        totalAmpMod *= FastMath::dbToGain(-(glLfo.value.am * glLfo.am.depthDb));
     }
 
     if (m_lfo.am.enable) {
-        totalAmpMod *= std::pow(10.0f, -(m_lfo.value.am * m_lfo.am.depthDb) / 20.0f);
+        totalAmpMod *= FastMath::dbToGain(-(m_lfo.value.am * m_lfo.am.depthDb));
     }
 
     envVal *= totalAmpMod;
@@ -380,7 +381,7 @@ void Opzx7Operator::getSample(float& output, float modulator, float feedbackModu
     currentPitchCent += glLfo.value.pm * (modWheel * 200.0f);
 
     // 蓄積した Cent を周波数倍率に変換
-    float lfoPitchMod = std::pow(2.0f, currentPitchCent / 1200.0f);
+    float lfoPitchMod = FastMath::centsToRatio(currentPitchCent);
 
     // ========================================================
     // 3. 位相と波形の生成
@@ -421,6 +422,9 @@ void Opzx7Operator::getSample(float& output, float modulator, float feedbackModu
     // 位相の変調
     float modulatedPhase = m_phase + (modulator * fmModIndex) + feedbackPhaseOffset;
 
+    // 帯域制限テーブルのレベルは今回の位相増分から決める
+    m_waveLevel = Opzx7WaveTable::getLevel(currentPhaseDelta / juce::MathConstants<float>::twoPi);
+
     // エンベロープが「掛かる前」の生の波形を取得
     float rawWave = calcWaveform(modulatedPhase, m_params.waveSelect);
 
@@ -456,14 +460,11 @@ void Opzx7Operator::getSample(float& output, float modulator, float feedbackModu
 
 float Opzx7Operator::calcWaveform(double phase, int wave)
 {
-    // 1. まず phase を 0.0 ～ 2π の範囲に丸め込む (ラジアン)
-    float p = std::fmod((float)phase, 2.0f * juce::MathConstants<float>::pi);
-
-    if (p < 0.0f) p += 2.0f * juce::MathConstants<float>::pi;
+    // 1. まず phase を正規化位相 (0.0 ～ 1.0) に丸め込む
+    float normPhase = (float)phase * (1.0f / juce::MathConstants<float>::twoPi);
+    normPhase -= std::floor(normPhase);
 
-    // サイン波と正規化位相を計算
-    float s = std::sin(p);
-    float normPhase = p / (2.0f * juce::MathConstants<float>::pi);
+    float p = normPhase * juce::MathConstants<float>::twoPi;
 
     // =================================================================
     // PCM波形の特別処理 (メンバ変数へのアクセスが必要なため分離)
@@ -530,7 +531,7 @@ float Opzx7Operator::calcWaveform(double phase, int wave)
             return (*m_pcmBuffer)[index1] * (1.0f - frac) + (*m_pcmBuffer)[index2] * frac;
         }
 
-        return s; // PCMバッファが無い場合はサイン波を返す
+        return std::sin(p); // PCMバッファが無い場合はサイン波を返す
     }
 
     // =================================================================
@@ -557,7 +558,7 @@ float Opzx7Operator::calcWaveform(double phase, int wave)
             return (*m_wtBuffer)[index1] * (1.0f - frac) + (*m_wtBuffer)[index2] * frac;
         }
 
-        return s; // データが無い場合はサイン波を返す
+        return std::sin(p); // データが無い場合はサイン波を返す
     }
 
     // =================================================================
@@ -584,271 +585,13 @@ float Opzx7Operator::calcWaveform(double phase, int wave)
             return (*m_wt2Buffer)[index1] * (1.0f - frac) + (*m_wt2Buffer)[index2] * frac;
         }
 
-        return s; // データが無い場合はサイン波を返す
+        return std::sin(p); // データが無い場合はサイン波を返す
     }
 
     // =================================================================
-    // ストラテジーによる高速な波形計算
+    // 解析的な波形は帯域制限済みのテーブルから引く
     // =================================================================
     int safeWave = std::clamp(wave, 0, Opzx7PrValue::waveShapes - 1);
 
-    // =================================================================
-    // 波形生成用のユーティリティ関数群
-    // =================================================================
-    auto isOddQuad = [](float phase) {
-        return phase < 0.25f || (phase >= 0.5f && phase < 0.75f);
-        };
-
-    auto doubleSine = [](float p) {
-        return std::sin(p * 2.0f);
-        };
-
-    auto halfLevelSign = [](float sine) {
-        if (sine > 0.5f) return 0.5f;
-        if (sine < -0.5f) return -0.5f;
-        return sine;
-        };
-
-    auto triangle = [](float phase) {
-        float value = phase * 4.0f;
-        if (phase < 0.25f) return value;
-        if (phase < 0.75f) return 2.0f - value;
-        return value - 4.0f;
-        };
-
-    auto dsTriangle = [](float phase) {
-        float position = phase >= 0.5f ? phase - 0.5f : phase;
-        float value = position * 8.0f;
-        if (position < 0.125f) return value;
-        if (position < 0.375f) return 2.0f - value;
-        return value - 4.0f;
-        };
-
-    auto diagram = [](float phase) {
-        float value = phase * 2.0f;
-        if (phase < 0.5f) return value;
-        return value - 2.0f;
-        };
-
-    auto dsDiagram = [](float phase) {
-        float position = phase >= 0.5f ? phase - 0.5f : phase;
-        float value = position * 4.0f;
-        if (position < 0.25f) return value;
-        return value - 2.0f;
-        };
-
-    auto absHalfSawUp = [](float phase) {
-        float value = phase * 2.0f;
-        if (phase < 0.5f) return value;
-        return value - 1.0f;
-        };
-
-    auto dsAbsHalfSawUp = [](float phase) {
-        float position = phase >= 0.5f ? phase - 0.5f : phase;
-        float value = position * 4.0f;
-        if (position < 0.25f) return value;
-        return value - 1.0f;
-        };
-
-    auto reverseSign = [](float phase, float nP) {
-        float s2 = std::sin(phase + 0.5f * juce::MathConstants<float>::pi);
-        if (nP < 0.25f) return 1.0f - s2;
-        if (nP < 0.5f) return 1.0f + s2;
-        if (nP < 0.75f) return -1.0f - s2;
-        return s2 - 1.0f;
-        };
-
-    auto doubleReverseSine = [](float phase, float nP) {
-        float s2 = std::sin((phase + 0.75f * juce::MathConstants<float>::pi) * 2.0f);
-        if (nP < 0.125f) return 1.0f + s2;
-        if (nP < 0.25f) return 1.0f - s2;
-        if (nP < 0.375f) return s2 - 1.0f;
-        return -1.0f - s2;
-        };
-
-    // =================================================================
-    // 波形ストラテジー配列の定義
-    // (引数: ラジアン位相 p, 正規化位相 n, サイン波 s)
-    // =================================================================
-    float val = 0.0f;
-    float sign = 0.0f;
-    uint8_t pi = 0;
-
-    switch (safeWave) {
-    case 0:
-        return s;
-    case 1:
-        return normPhase < 0.5f ? s : 0.0f;
-    case 2:
-        return std::abs(s);
-    case 3:
-        return isOddQuad(normPhase) ? std::abs(s) : 0.0f;
-    case 4:
-        return normPhase < 0.5f ? doubleSine(p) : 0.0f;
-    case 5:
-        return normPhase < 0.5f ? std::abs(doubleSine(p)) : 0.0f;
-    case 6:
-        return normPhase < 0.5f ? 1.0f : -1.0f;
-    case 7:
-        val = 1.0f - normPhase * 2.0f;
-        
-        return val * val * val;
-    case 8:
-        return halfLevelSign(s);
-    case 9:
-        return normPhase < 0.5f ? halfLevelSign(s) : 0.0f;
-    case 10:
-        return std::abs(halfLevelSign(s));
-    case 11:
-        return isOddQuad(normPhase) ? std::abs(halfLevelSign(s)) : 0.0f;
-    case 12:
-        return normPhase < 0.5f ? std::sin(p * 2.0f) * 0.5f : 0.0f;
-    case 13:
-        return normPhase < 0.5f ? std::abs(std::sin(p * 2.0f)) * 0.5f : 0.0f;
-    case 14:
-        return normPhase < 0.5f ? 1.0f : 0.0f;
-    case 15:
-        return 0.0f; // WT
-    case 16:
-        return triangle(normPhase);
-    case 17:
-        return normPhase < 0.5f ? triangle(normPhase) : 0.0f;
-    case 18:
-        return std::abs(triangle(normPhase));
-    case 19:
-        return isOddQuad(normPhase) ? std::abs(triangle(normPhase)) : 0.0f;
-    case 20:
-        return normPhase < 0.5f ? dsTriangle(normPhase) : 0.0f;
-    case 21:
-        return normPhase < 0.5f ? std::abs(dsTriangle(normPhase)) : 0.0f;
-    case 22:
-        return isOddQuad(normPhase) ? 1.0f : 0.0f;
-    case 23:
-        return 0.0f; // WT2
-    case 24:
-        return diagram(normPhase);
-    case 25:
-        return normPhase < 0.5f ? diagram(normPhase) : 0.0f;
-    case 26:
-        return absHalfSawUp(normPhase);
-    case 27:
-        return isOddQuad(normPhase) ? absHalfSawUp(normPhase) : 0.0f;
-    case 28:
-        return normPhase < 0.5f ? dsDiagram(normPhase) : 0.0f;
-    case 29:
-        return normPhase < 0.5f ? dsAbsHalfSawUp(normPhase) : 0.0f;
-    case 30:
-        return normPhase < 0.25f ? 1.0f : 0.0f;
-    case 31:
-        return 0.0f; // PCM
-    case 32:
-        return normPhase < 0.5f ? std::abs(std::sin(p * 2.0f)) : 0.0f;
-    case 33:
-        sign = (normPhase < 0.5f) ? 1.0f : -1.0f;
-        return sign * (1.0f - std::pow(1.0f - std::abs(s), 4.0f));
-    case 34:
-        return 1.0f - normPhase * 2.0f;
-    case 35:
-        return normPhase * 2.0f - 1.0f;
-    case 36:
-        return (1.0f - normPhase * 2.0f) * 0.5f + s * 0.5f;
-    case 37:
-        return normPhase < 0.25f ? 1.0f : -1.0f;
-    case 38:
-        return normPhase < 0.125f ? 1.0f : -1.0f;
-    case 39:
-        return normPhase < 0.0625f ? 1.0f : -1.0f;
-    case 40:
-        return std::tanh(s * 5.0f);
-    case 41:
-        return std::exp(-100.0f * std::pow(normPhase - 0.5f, 2.0f)) * 2.0f - 1.0f;
-    case 42:
-        return std::sin(p) + std::sin(p * 3.0f) * 0.5f + std::sin(p * 5.0f) * 0.25f;
-    case 43:
-        return (1.0f - normPhase * 2.0f) * std::sin(p * 4.0f);
-    case 44:
-        return (1.0f - normPhase * 2.0f) * std::sin(p * 8.0f);
-    case 45:
-        val = (normPhase < 0.5f ? (4.0f * normPhase - 1.0f) : (3.0f - 4.0f * normPhase));
-
-        return val * std::sin(p * 3.0f);
-    case 46:
-        return s * s * s;
-    case 47:
-        return std::sin(p) * std::sin(p * 2.0f);
-    case 48:
-        return s + 0.5f * std::sin(p * 2.0f) + 0.25f * std::sin(p * 4.0f);
-    case 49:
-        return s * std::cos(p * 2.5f);
-    case 50:
-        return std::sin(p) * std::sin(p * 1.414f);
-    case 51:
-        return std::sin(p) * std::cos(p * 0.5f);
-    case 52:
-        return std::sin(p * 13.0f) * std::cos(p * 7.0f) * std::sin(p * 2.0f);
-    case 53:
-        return (1.0f - std::cos(p)) * std::sin(p * 5.0f) * 0.5f;
-    case 54:
-        return (1.0f - std::cos(p)) * std::sin(p * 9.0f) * 0.5f;
-    case 55:
-        return std::round(s * 2.0f) / 2.0f;
-    case 56:
-        return std::round(s * 4.0f) / 4.0f;
-    case 57:
-        val = s * 1.5f;
-
-        if (val > 1.0f) return 2.0f - val;
-        if (val < -1.0f) return -2.0f - val;
-
-        return val;
-    case 58:
-        val = s * 2.5f;
-
-        return std::sin(val * juce::MathConstants<float>::halfPi);
-    case 59:
-        pi = (uint8_t)(normPhase * 255.0f);
-        pi = pi ^ (pi >> 1);
-        
-        return ((float)pi / 255.0f) * 2.0f - 1.0f;
-    case 60:
-        pi = (uint8_t)(normPhase * 255.0f);
-        pi = pi & (pi << 1);
-
-        return ((float)pi / 255.0f) * 2.0f - 1.0f;
-    case 61:
-        return std::sin(p + 1.0f * std::sin(p));
-    case 62:
-        return std::sin(p + 2.0f * std::sin(p));
-    case 63:
-        return reverseSign(p, normPhase);
-    case 64:
-        return normPhase < 0.5f ? s : 0.0f;
-    case 65:
-        return normPhase < 0.5f ? reverseSign(p, normPhase) : 0.0f;
-    case 66:
-        return normPhase < 0.5f ? doubleSine(p) : 0.0f;
-    case 67:
-        return normPhase < 0.5f ? doubleReverseSine(p, normPhase) : 0.0f;
-    case 68:
-        return normPhase < 0.5f ? std::abs(doubleSine(p)) : 0.0f;
-    case 69:
-        return normPhase < 0.5f ? std::abs(doubleReverseSine(p, normPhase)) : 0.0f;
-    case 70:
-        val = triangle(normPhase);
-        
-        return val * val * val;
-    case 71:
-        val = triangle(normPhase);
-        sign = (val >= 0.0f) ? 1.0f : -1.0f;
-        val = std::abs(val);
-
-        return sign * (1.0f - std::sqrt(std::max(0.0f, 1.0f - val * val)));
-    case 72:
-        val = std::fmod(normPhase * 2.0f, 1.0f);
-        sign = (normPhase < 0.5f) ? 1.0f : -1.0f;
-
-        return sign * std::exp(-val * 8.0f);
-    default:
-        return s;
-    }
+    return m_waveTable->lookup(safeWave, m_waveLevel, normPhase);
 }
@@ -5,6 +5,7 @@
 #include "../../../Effect/Envelope/Pitch/Adsr/EnvPirchAdsr.h"
 #include "../../../Generator/Noise/Lfsr/GenNoiseLfsr.h"
 #include "../../../Generator/Fm/Fix/FmFix.h"
+#include "../../../Generator/Fm/Wave/FmWaveTable.h"
 #include "../../../Effect/Detune/Opzx7/DetuneOpzx7.h"
 #include "../../../Effect/Lfo/Opzx7/LfoOpzx7.h"
 #include "../../../Effect/Envelope/Amp/Opzx7Adddr/EnvOpzx7Adddr.h"
@@ -75,6 +76,10 @@ private:
 
 	std::array<float, 8> fVector = { 0.0f };
 
+	// 帯域制限済みの波形テーブル (全オペレータで共有)
+	const Opzx7WaveTable* m_waveTable = &Opzx7WaveTable::getInstance();
+	int m_waveLevel = 0;
+
 	// OPZX7 の外部 PCM データ用
 	std::vector<float>* m_pcmBuffer = nullptr;
 	// OPZX7 の波形データ用
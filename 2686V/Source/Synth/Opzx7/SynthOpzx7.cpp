@@ -171,7 +171,11 @@ const std::array<Opzx7Core::AlgRouting, Opzx7PrValue::algorithms> Opzx7Core::rou
     } };
 
 void Opzx7Core::prepare(double sampleRate) {
-    if (sampleRate > 0.0) m_hostSampleRate = sampleRate;
+    if (sampleRate > 0.0) {
+        m_hostSampleRate = sampleRate;
+        m_outGain.prepare(sampleRate);
+    }
+    m_resampler.prepare();
 
     double target = getTargetRate(m_rateIndex);
 
@@ -213,10 +217,18 @@ void Opzx7Core::setSampleRate(double sampleRate) {
 
 void Opzx7Core::setParameters(const SynthParams& params) {
     m_level = params.opzx7.level;
+    m_resampleQuality = params.resampleQuality;
 
     m_algorithm = params.opzx7.algFb.algorithm; // Range: 0-27
     m_algorithmCodeBase = m_algorithm << m_algorithmCodeShift; // x16
-    m_algMatrix = params.opzx7.algFb.matrix;
+    // マトリックス本体は版数が変わった時だけコピーする
+    const auto& matrix = params.opzx7.algFb.matrix;
+    if (matrix.version != m_algMatrix.version) {
+        m_algMatrix = matrix;
+    }
+    else {
+        m_algMatrix.mode = matrix.mode;
+    }
 
     // ユニゾン・ハーモニー用
     m_isMonoMode = params.monoMode;
@@ -296,6 +308,8 @@ void Opzx7Core::setParameters(const SynthParams& params) {
 }
 
 void Opzx7Core::noteOn(float freq, float velocity, int midiNote, bool isLegato) {
+    if (!isLegato) m_outGain.restart();
+
     int noteNum = (int)(69.0 + 12.0 * std::log2(freq / 440.0));
     float gain = std::max(0.01f, velocity * 0.25f);
 
@@ -397,9 +411,10 @@ void Opzx7Core::setModulationWheel(int wheelValue)
 }
 
 float Opzx7Core::getSample() {
-    double targetRate = getTargetRate(m_rateIndex);
-    double stepSize = targetRate / m_hostSampleRate;
+    return renderSample(getTargetRate(m_rateIndex) / m_hostSampleRate);
+}
 
+float Opzx7Core::renderSample(double stepSize) {
     m_rateAccumulator += stepSize;
 
     float currentOut[Opzx7PrValue::ops];
@@ -447,13 +462,18 @@ float Opzx7Core::getSample() {
         finalOut *= 2.0f; // ゲイン補正
 
         m_lastSample = finalOut;
+
+        m_resampler.push(m_lastSample);
     }
 
+    // 帯域制限した補間 (品質が Linear の時は従来の直線補間)
+    if (m_resampler.isBandLimited()) return m_resampler.read(m_rateAccumulator);
+
     float fraction = (float)(m_rateAccumulator / stepSize);
 
     if (fraction > 1.0f) fraction = 1.0f;
 
-    return (m_prevSample + (m_lastSample - m_prevSample) * fraction) * m_level;
+    return m_prevSample + (m_lastSample - m_prevSample) * fraction;
 }
 
 void Opzx7Core::setPcmBuffer(int opIndex, std::vector<float>* pcmData)
@@ -477,13 +497,13 @@ void Opzx7Core::setWt2Buffer(int opIndex, std::vector<float>* wtData)
     }
 }
 
-void Opzx7Core::renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive)
+void Opzx7Core::renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive)
 {
-    float sample = getSample();
-
+    // パン・ユニゾン補正の目標値はブロックごとに1回だけ計算し、ブロック内ではサンプル単位で補間する
     // ユニゾン・ハーモニー向けに変更
     float basePanL = m_panpot_l_rate;
     float basePanR = m_panpot_r_rate;
+    float gainComp = 1.0f;
 
     if (m_unisonTotal > 1) {
         float spreadPos = ((float)m_unisonIndex / (float)(m_unisonTotal - 1)) * 2.0f - 1.0f; // -1.0 to 1.0
@@ -496,14 +516,52 @@ void Opzx7Core::renderNextBlock(float* outR, float* outL, int startSample, int s
 
         // 音量補正 (ボイス数が増えると爆音になるため下げる)
         // ルートを取るか、単純に割るかは好みですが、単純割りの方が安全です
-        float gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
-        sample *= gainComp;
+        gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
     }
 
-    outL[startSample + sampleIdx] += sample * basePanL;
-    outR[startSample + sampleIdx] += sample * basePanR;
+    // レベルもここで掛ける (ブロック境界でゲインが段差にならないよう、目標値へ向けてなめらかに動かす)
+    m_outGain.setTarget(basePanL * gainComp * m_level, basePanR * gainComp * m_level);
+
+    isActive = true;
+
+    // レート・品質が変わった時だけ変換の設定を作り直す
+    m_resampler.configure(getTargetRate(m_rateIndex), m_hostSampleRate, m_resampleQuality);
+
+    // モノラルの出力を小分けのバッファへ書き出し、パン・ユニゾン補正を掛けた加算はまとめてベクトル演算で行う
+    // (FloatVectorOperations が SSE/AVX/NEON を選び、使えない環境ではスカラーで処理する)
+    const int endSample = startSample + numSamples;
+    const double stepSize = getTargetRate(m_rateIndex) / m_hostSampleRate; // ブロック内で変化しない
 
-    isActive = isPlaying();
+    for (int pos = startSample; pos < endSample && isActive; )
+    {
+        const int chunkSize = std::min(endSample - pos, renderChunkSize);
+        int rendered = 0;
+
+        while (rendered < chunkSize)
+        {
+            m_renderChunk[rendered++] = renderSample(stepSize);
+
+            if (!isPlaying())
+            {
+                isActive = false;
+                break;
+            }
+        }
+
+        if (m_outGain.isSmoothing()) {
+            // ゲインの補間中はサンプルごとに掛ける
+            for (int n = 0; n < rendered; ++n) {
+                outL[pos + n] += m_renderChunk[n] * m_outGain.left.getNextValue();
+                outR[pos + n] += m_renderChunk[n] * m_outGain.right.getNextValue();
+            }
+        }
+        else {
+            juce::FloatVectorOperations::addWithMultiply(outL + pos, m_renderChunk.data(), m_outGain.left.getTargetValue(), rendered);
+            juce::FloatVectorOperations::addWithMultiply(outR + pos, m_renderChunk.data(), m_outGain.right.getTargetValue(), rendered);
+        }
+
+        pos += rendered;
+    }
 }
 
 void Opzx7Core::clearPcmBuffer(int opIndex) {
@@ -527,6 +585,12 @@ void Opzx7Core::clearWt2Buffer(int opIndex) {
 void Opzx7Core::updateRoutingCache()
 {
     if (m_algMatrix.mode == 1) {
+        // 同じ版数のマトリックスは組み立て済みなので何もしない
+        if (m_cachedAlgorithm == matrixAlgorithm && m_cachedMatrixVersion == m_algMatrix.version) return;
+
+        m_cachedAlgorithm = matrixAlgorithm;
+        m_cachedMatrixVersion = m_algMatrix.version;
+
         Opzx7Core::AlgRouting customRouting;
         customRouting.out.fill(0.0f);
         for (auto& row : customRouting.mod) row.fill(0.0f);
@@ -6,6 +6,8 @@
 #include <algorithm>
 
 #include "../../Core/Fm/FmCore.h"
+#include "../../Core/Synth/SynthSmoother.h"
+#include "../../Core/Synth/SynthResampler.h"
 #include "../../Generator/Noise/Lfsr/GenNoiseLfsr.h"
 #include "../../Effect/Lfo/Opzx7/LfoOpzx7.h"
 #include "../../Advanced/Curve/AdvancedCurve.h"
@@ -18,7 +20,7 @@
 // Base: OPZ (YM2414)
 // Extension: OPX (YMF271) Algorithms & MA-7 Waveforms
 // ==========================================================
-class Opzx7Core : public FmCore
+class Opzx7Core final : public FmCore
 {
 public:
     Opzx7Core() : FmCore() {}
@@ -43,7 +45,7 @@ public:
     void setPcmBuffer(int opIndex, std::vector<float>* pcmData);
     void setWtBuffer(int opIndex, std::vector<float>* wtData);
     void setWt2Buffer(int opIndex, std::vector<float>* wtData);
-    void renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive) override;
+    void renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive) override;
     void setCurveCore(CurveCore* p_curveCore);
     void clearPcmBuffer(int opIndex);
     void clearWtBuffer(int opIndex);
@@ -105,7 +107,10 @@ private:
 
     Opzx7LfoCore m_lfo;
 
+    static constexpr int matrixAlgorithm = -2; // m_cachedAlgorithm がマトリックスモードのルーティングを指す印
     int m_cachedAlgorithm = -1;
+    unsigned int m_cachedMatrixVersion = 0;
+    float renderSample(double stepSize); // getSample() の本体 (stepSize: 内部レート / ホストレート)
     void updateRoutingCache();
     void applyRoutingToCache(const AlgRouting& r);
 
@@ -116,10 +121,17 @@ private:
     AlgMatrixParams m_algMatrix;
 
     float m_level = 1.0f;
+    StereoGainSmoother m_outGain; // レベル・パンはここでサンプル単位に補間して掛ける
+
+    // renderNextBlock でパン・ゲインをまとめて掛けるためのモノラル作業バッファ
+    static constexpr int renderChunkSize = 64;
+    alignas(32) std::array<float, renderChunkSize> m_renderChunk{};
 
     // Rate & Quality
     int m_rateIndex = 1;
     double m_rateAccumulator = 0.0;
+    VirtualRateResampler m_resampler; // 仮想レートからホストのレートへの変換 (品質が Linear 以外の時)
+    int m_resampleQuality = VirtualRateResampler::Standard;
     float m_lastSample = 0.0f;
     float m_prevSample = 0.0f;
     float m_quantizeSteps = 0.0f;
@@ -4,6 +4,7 @@
 #include "../../Generator/Pcm/Adpcm/GenAdpcm.h"
 #include "../../Generator/Pcm/Dpcm/GenDpcm.h"
 #include "../../Generator/Pcm/Helper/GenPcmHelper.h"
+#include "../../Core/Synth/SynthFastMath.h"
 
 void RhythmPad::prepare(double hostSampleRate)
 {
@@ -39,10 +40,17 @@ void RhythmPad::setSampleRate(double sampleRate)
 }
 
 // Set data (Same logic as AdpcmCore)
-void RhythmPad::setSampleData(const std::vector<float>& sourceData, double sourceRate)
+void RhythmPad::setSampleData(const PcmSample* sample)
 {
-    m_rawBuffer = sourceData;
-    m_sourceRate = sourceRate;
+    m_sample = sample;
+    if (m_sample == nullptr) {
+        m_encoded = nullptr;
+        m_encodePending = false;
+        return;
+    }
+
+    m_sourceRate = m_sample->sourceRate;
+    m_encoded = nullptr; // 前のサンプルのエンコード結果は使えない
     refreshPcmBuffer();
 }
 
@@ -128,7 +136,7 @@ void RhythmPad::start(float velocity, bool isLegato, float freq, float uOffset,
     m_unisonTotal = uTotal;
 
     // ADPCMモードとDPCMモードを共通で「エンコードバッファ使用モード」として判定
-    bool isEncodedMode = (m_qualityMode == adpcmMode || m_qualityMode == dpcmMode);
+    bool isEncodedMode = (m_playMode == adpcmMode || m_playMode == dpcmMode);
     double currentBufferRate = isEncodedMode ? m_bufferSampleRate : m_sourceRate;
     float finalFreq = freq;
     float oldBaseLevel = m_baseLevel;
@@ -280,16 +288,17 @@ float RhythmPad::getSample()
     }
 
     float output = 0.0f;
-    bool isEncodedMode = (m_qualityMode == adpcmMode || m_qualityMode == dpcmMode);
+    bool isEncodedMode = (m_playMode == adpcmMode || m_playMode == dpcmMode);
     double currentBufferRate = m_sampleRate;
 
     // ノイズを出すために、バッファが空でも最後まで通す
-    if (isEncodedMode && !m_pcmBuffer.empty()) {
+    if (isEncodedMode && m_encoded != nullptr && !m_encoded->data.empty()) {
         if (m_hasFinished) return 0.0f;
 
         currentBufferRate = m_bufferSampleRate;
 
-        size_t totalSize = m_pcmBuffer.size();
+        const auto& pcmBuffer = m_encoded->data;
+        size_t totalSize = pcmBuffer.size();
 
         if (totalSize == 0) return 0.0f;
 
@@ -387,10 +396,10 @@ float RhythmPad::getSample()
         float s_m1, s_0, s_1, s_2;
 
         // エンコードバッファ (int16_t) から読み込み、正規化
-        s_m1 = m_pcmBuffer[idx_m1] / 32768.0f;
-        s_0 = m_pcmBuffer[idx_0] / 32768.0f;
-        s_1 = m_pcmBuffer[idx_1] / 32768.0f;
-        s_2 = m_pcmBuffer[idx_2] / 32768.0f;
+        s_m1 = pcmBuffer[idx_m1] / 32768.0f;
+        s_0 = pcmBuffer[idx_0] / 32768.0f;
+        s_1 = pcmBuffer[idx_1] / 32768.0f;
+        s_2 = pcmBuffer[idx_2] / 32768.0f;
 
         // =========================================================
         // 補間処理 (Interpolation)
@@ -443,11 +452,12 @@ float RhythmPad::getSample()
         }
         }
     }
-    else if (!isEncodedMode && !m_rawBuffer.empty()){
+    else if (!isEncodedMode && m_sample != nullptr && !m_sample->raw.empty()){
         if (m_hasFinished) return 0.0f;
 
         // 総サイズと再生終了位置の計算
-        size_t totalSize = m_rawBuffer.size();
+        const auto& rawBuffer = m_sample->raw;
+        size_t totalSize = rawBuffer.size();
 
         currentBufferRate = m_sourceRate;
 
@@ -544,10 +554,10 @@ float RhythmPad::getSample()
         // =========================================================
         float s_m1, s_0, s_1, s_2;
 
-        s_m1 = m_rawBuffer[idx_m1];
-        s_0 = m_rawBuffer[idx_0];
-        s_1 = m_rawBuffer[idx_1];
-        s_2 = m_rawBuffer[idx_2];
+        s_m1 = rawBuffer[idx_m1];
+        s_0 = rawBuffer[idx_0];
+        s_1 = rawBuffer[idx_1];
+        s_2 = rawBuffer[idx_2];
 
         // =========================================================
         // 補間処理 (Interpolation)
@@ -601,7 +611,7 @@ float RhythmPad::getSample()
         }
 
         // Raw/BitCrusher モード時のビットリダクション
-        output = GenPcmHelper::bitReduction(output, m_qualityMode);
+        output = GenPcmHelper::bitReduction(output, m_playMode);
     }
 
     // ==========================================
@@ -615,7 +625,7 @@ float RhythmPad::getSample()
     if (m_lfo.am.enable) {
         // depthDb はセットアップ時に計算済みなので、そのままdB減衰に変換
         float attenDb = m_lfo.value.am * m_lfo.am.depthDb;
-        amMultiplier = std::pow(10.0f, -attenDb / 20.0f);
+        amMultiplier = FastMath::dbToGain(-attenDb);
     }
 
     // 2. Pitch Modulation (PM / 音程)
@@ -627,7 +637,7 @@ float RhythmPad::getSample()
     }
 
     // セントを周波数倍率(レシオ)に変換
-    float opzx7PitchMod = std::pow(2.0f, pitchModCents / 1200.0f);
+    float opzx7PitchMod = FastMath::centsToRatio(pitchModCents);
     float mwPitchMod = 1.0f + (m_lfo.value.pm * (m_modWheel * 0.03f));
     double currentIncrement = m_pitchAdsr.process(m_pitchRatio * m_pitchBendRatio * mwPitchMod);
     currentIncrement = m_ssgSwPenv11.process(currentIncrement);
@@ -658,60 +668,80 @@ float RhythmPad::getSample()
 
 void RhythmPad::refreshPcmBuffer()
 {
-    // Copy the same resampling & encoding logic as AdpcmCore here
-    // (To avoid code duplication, it's best to extract Codec to a separate header, but omitted here)
-    if (m_rawBuffer.empty()) return;
+    if (m_sample == nullptr || m_sample->raw.empty()) return;
 
     double targetRate = getTargetRate(m_rateIndex);
 
-    if (targetRate > m_sourceRate) targetRate = m_sourceRate;
-    m_bufferSampleRate = targetRate;
+    // Do not upsample beyond source rate for the ADPCM buffer gen
+    double bufferRate = GenPcmPool::getEncodedRate(*m_sample, targetRate);
 
-    m_adsr.prepare(m_bufferSampleRate);
-    m_pitchAdsr.prepare(0, m_bufferSampleRate);
-    m_ssgSwEnv.prepare(0, m_bufferSampleRate);
-    m_ssgSwEnv11.prepare(0, m_bufferSampleRate);
-    m_ssgSwPenv11.prepare(0, m_bufferSampleRate);
-    m_noiseGen.prepare(m_bufferSampleRate);
+    // Raw再生モードではエンコードバッファを使わないので、すぐに切り替える
+    if (m_qualityMode != adpcmMode && m_qualityMode != dpcmMode) {
+        m_encodePending = false;
+        applyPcmBuffer(m_qualityMode, bufferRate, nullptr);
+        return;
+    }
 
-    double step = m_sourceRate / targetRate;
+    // エンコードはプールのスレッドが行うので、ここでは作成済みのバッファを探すだけ
+    // まだ無ければ、出来上がるまで今のバッファ (レート・エンベロープもそのまま) で鳴らし続け、renderNextBlock で拾って切り替える
+    // (このサンプルで鳴らせるバッファがまだ何も無い時だけ、無音で待つ)
+    m_pendingBufferRate = bufferRate;
 
-    m_pcmBuffer.clear();
-    m_pcmBuffer.reserve((size_t)(m_rawBuffer.size() / step) + 1);
+    if (auto* encoded = m_sample->findEncoded(m_qualityMode, bufferRate)) {
+        m_encodePending = false;
+        applyPcmBuffer(m_qualityMode, bufferRate, encoded);
+        return;
+    }
 
-    double pos = 0;
+    m_encodePending = true;
 
-    if (m_qualityMode == dpcmMode) {
-        DpcmCodec codec;
-        codec.reset();
+    const bool isPlayable = (m_playMode != adpcmMode && m_playMode != dpcmMode) || m_encoded != nullptr;
+    if (!isPlayable) applyPcmBuffer(m_qualityMode, bufferRate, nullptr);
+}
 
-        while (pos < m_rawBuffer.size()) {
-            int index = (int)pos;
-            if (index >= m_rawBuffer.size()) break;
-            int16_t input = (int16_t)(m_rawBuffer[index] * 32767.0f);
-            m_pcmBuffer.push_back(codec.decode(codec.encode(input)));
-            pos += step;
-        }
-    }
-    else { // adpcmMode
-        Ym2608AdpcmCodec codec;
-        codec.reset();
+void RhythmPad::applyPcmBuffer(int mode, double bufferRate, const PcmEncoded* encoded)
+{
+    auto getPlayRate = [this] {
+        return (m_playMode == adpcmMode || m_playMode == dpcmMode) ? m_bufferSampleRate : m_sourceRate;
+    };
 
-        while (pos < m_rawBuffer.size()) {
-            int index = (int)pos;
-            if (index >= m_rawBuffer.size()) break;
-            int16_t input = (int16_t)(m_rawBuffer[index] * 32767.0f);
-            m_pcmBuffer.push_back(codec.decode(codec.encode(input)));
-            pos += step;
-        }
+    const double oldRate = getPlayRate();
+
+    m_playMode = mode;
+    m_encoded = encoded;
+    m_bufferSampleRate = bufferRate;
+
+    // 発音中でも途切れないよう、再生位置と再生速度を新しいバッファのレートに合わせる
+    const double newRate = getPlayRate();
+    if (oldRate > 0.0 && newRate != oldRate) {
+        const double scale = newRate / oldRate;
+        m_position *= scale;
+        m_pitchRatio = (float)(m_pitchRatio * scale);
     }
 
-    GenPcmHelper::lowPassFilter(m_pcmBuffer);
+    m_adsr.prepare(m_bufferSampleRate);
+    m_pitchAdsr.prepare(0, m_bufferSampleRate);
+    m_ssgSwEnv.prepare(0, m_bufferSampleRate);
+    m_ssgSwEnv11.prepare(0, m_bufferSampleRate);
+    m_ssgSwPenv11.prepare(0, m_bufferSampleRate);
+    m_noiseGen.prepare(m_bufferSampleRate);
 }
 
 void RhythmPad::clearBuffer() {
-    m_pcmBuffer.clear();
-    m_rawBuffer.clear();
+    m_encoded = nullptr;
+    m_encodePending = false;
+    m_sample = nullptr;
+}
+
+void RhythmPad::pollEncoded()
+{
+    if (!m_encodePending || m_sample == nullptr) return;
+
+    // 出来上がった時に、バッファ・レート・エンベロープをまとめて切り替える
+    if (auto* encoded = m_sample->findEncoded(m_qualityMode, m_pendingBufferRate)) {
+        m_encodePending = false;
+        applyPcmBuffer(m_qualityMode, m_pendingBufferRate, encoded);
+    }
 }
 
 void RhythmCore::prepare(double sampleRate)
@@ -749,10 +779,10 @@ void RhythmCore::setParameters(const SynthParams& params)
 }
 
 // Load sample from external source (Specify Pad index)
-void RhythmCore::setSampleData(int padIndex, const std::vector<float>& data, double rate)
+void RhythmCore::setSampleData(int padIndex, const PcmSample* sample)
 {
     if (padIndex >= 0 && padIndex < MaxRhythmPads) {
-        pads[padIndex].setSampleData(data, rate);
+        pads[padIndex].setSampleData(sample);
     }
 }
 
@@ -879,18 +909,31 @@ void RhythmCore::getSampleStereo(float& outL, float& outR)
     }
 }
 
-void RhythmCore::renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive)
+void RhythmCore::renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive)
 {
-    float padOutL = 0.0f;
-    float padOutR = 0.0f;
+    for (auto& pad : pads) {
+        pad.pollEncoded();
+    }
+
+    isActive = true;
+
+    for (int i = startSample; i < startSample + numSamples; ++i)
+    {
+        float padOutL = 0.0f;
+        float padOutR = 0.0f;
 
-    // RhythmCore 内部で Pan 適用済みのステレオミックスを受け取る
-    getSampleStereo(padOutL, padOutR);
+        // RhythmCore 内部で Pan 適用済みのステレオミックスを受け取る
+        getSampleStereo(padOutL, padOutR);
 
-    outL[startSample + sampleIdx] += padOutL;
-    outR[startSample + sampleIdx] += padOutR;
+        outL[i] += padOutL;
+        outR[i] += padOutR;
 
-    isActive = isPlaying();
+        if (!isPlaying())
+        {
+            isActive = false;
+            break;
+        }
+    }
 }
 
 void RhythmCore::clearBuffer(int padIndex) {
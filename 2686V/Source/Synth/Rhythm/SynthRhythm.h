@@ -16,13 +16,16 @@
 #include "../../Advanced/Curve/AdvancedCurve.h"
 #include "../../Generator/Noise/Ssg/GenNoiseSsg.h"
 #include "../../Generator/Fm/Fix/FmFix.h"
+#include "../../Generator/Pcm/Pool/GenPcmPool.h"
 
 // Class representing a single drum pad
 class RhythmPad
 {
 public:
-    std::vector<float> m_rawBuffer;     // Raw Data (32bit)
-    std::vector<int16_t> m_pcmBuffer;   // Processed Data (4bit ADPCM/DPCM)
+    const PcmSample* m_sample = nullptr;      // Raw Data (32bit, プロセッサが所有)
+    const PcmEncoded* m_encoded = nullptr; // Processed Data (4bit ADPCM/DPCM, プールのスレッドが作成)
+    bool m_encodePending = false;          // 現在の設定のエンコード完了待ち (その間は前のバッファで鳴らす)
+    double m_pendingBufferRate = 16000.0;  // 完了待ちのエンコードのレート
 
     double m_position = 0.0;
     double m_sampleRate = 44100.0; // DAW Host Sample Rate
@@ -38,6 +41,7 @@ public:
 	float m_panL = 1.0f;
     float m_panR = 1.0f;
     int m_qualityMode = 6; // ADPCM
+    int m_playMode = 6;    // 今鳴らしているバッファのモード (エンコード完了待ちの間は前の設定のまま)
     int m_rateIndex = 5;   // 16kHz
     int m_interpolationMode = 1;
     bool m_isOneShot = true;
@@ -64,7 +68,7 @@ public:
 
 	void prepare(double hostSampleRate);
     void setSampleRate(double sampleRate);
-    void setSampleData(const std::vector<float>& sourceData, double sourceRate);
+    void setSampleData(const PcmSample* sample);
     void setParameters(const RhythmPadParams& params);
     void triggerRelease(double hostSampleRate);
     void setPitchBend(float pitchBend);
@@ -75,6 +79,7 @@ public:
     float getSample();
     void setCurveCore(CurveCore* p_curveCore);
     void clearBuffer();
+    void pollEncoded();
 
     // ユニゾン・ハーモニー用
     void setMonoMode(bool isMono) { m_isMonoMode = isMono; }
@@ -94,6 +99,8 @@ private:
     float m_pitchRatio = 1.0f;
 
     void refreshPcmBuffer();
+    // 鳴らすバッファを切り替える (モード・レートとそれに合わせたエンベロープ・ノイズのレートをまとめて)
+    void applyPcmBuffer(int mode, double bufferRate, const PcmEncoded* encoded);
 
     // ユニゾン・ハーモニー用
     bool m_isMonoMode = false;
@@ -101,7 +108,7 @@ private:
     float m_unisonPhaseOffset = 0.0f;
 };
 
-class RhythmCore : public SynthCore
+class RhythmCore final : public SynthCore
 {
 public:
     RhythmCore() : SynthCore() {}
@@ -112,7 +119,7 @@ public:
     void prepare(double sampleRate);
     void setSampleRate(double sampleRate) override;
     void setParameters(const SynthParams& params);
-    void setSampleData(int padIndex, const std::vector<float>& data, double rate);
+    void setSampleData(int padIndex, const PcmSample* sample);
     void noteOn(float freq, float velocity, int midiNote, bool isLegato = false) override;
     void noteOff() override;
     bool isPlaying() const override;
@@ -120,7 +127,7 @@ public:
     void setModulationWheel(int wheelValue) override;
     void setPitchBendRatio(float ratio) override;
     void getSampleStereo(float& outL, float& outR);
-    void renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive) override;
+    void renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive) override;
     void setCurveCore(CurveCore* p_curveCore);
     void clearBuffer(int padIndex);
 
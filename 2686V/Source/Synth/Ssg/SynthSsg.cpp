@@ -1,6 +1,7 @@
 ﻿#include "./SynthSsg.h"
 
 #include "../../Core/Synth/SynthHelpers.h"
+#include "../../Core/Synth/SynthFastMath.h"
 
 const std::array<float, 9> SsgCore::dutyPresets = { 0.5f, 0.4375f, 0.375f, 0.3125f, 0.25f, 0.20f, 0.1875f, 0.125f, 0.0625f };
 
@@ -10,7 +11,9 @@ SsgCore::SsgCore() : SynthCore() {
 void SsgCore::prepare(double sampleRate) {
     if (sampleRate > 0.0) {
         m_sampleRate = sampleRate;
+        m_outGain.prepare(sampleRate);
     }
+    m_resampler.prepare();
 
     m_adsr.prepare(m_sampleRate);
 	m_pitchAdsr.prepare(0, m_sampleRate);
@@ -47,6 +50,8 @@ void SsgCore::setSampleRate(double sampleRate) {
 void SsgCore::setParameters(const SynthParams& params)
 {
     m_level = params.ssg.level;
+    m_resampleQuality = params.resampleQuality;
+    m_antialias = params.oscAntialias;
 
     m_tone = params.ssg.tn.tone;
     m_mix = params.ssg.tn.mix;
@@ -103,6 +108,8 @@ void SsgCore::setParameters(const SynthParams& params)
 
 void SsgCore::noteOn(float freq, float velocity, int midiNote, bool isLegato)
 {
+    if (!isLegato) m_outGain.restart();
+
     // =====================================================================
     // モノフォニック・レガート時は、音量（ベロシティ）を更新しない！
     // 1音目の音量をそのまま引き継ぐことで、音量ジャンプを完全に防ぐ。
@@ -328,7 +335,7 @@ float SsgCore::getSample()
         if (m_lfo.am.enable) {
             // depthDb はセットアップ時に計算済みなので、そのままdB減衰に変換
             float attenDb = m_lfo.value.am * m_lfo.am.depthDb;
-            amMultiplier = std::pow(10.0f, -attenDb / 20.0f);
+            amMultiplier = FastMath::dbToGain(-attenDb);
         }
 
         // 2. Pitch Modulation (PM / 音程)
@@ -340,7 +347,7 @@ float SsgCore::getSample()
         }
 
         // セントを周波数倍率(レシオ)に変換
-        float opzx7PitchMod = std::pow(2.0f, pitchModCents / 1200.0f);
+        float opzx7PitchMod = FastMath::centsToRatio(pitchModCents);
  
         float modDepth = m_modWheel * 0.03f;
         float mwPitchMod = 1.0f + (m_lfo.value.pm * modDepth);
@@ -414,6 +421,9 @@ float SsgCore::getSample()
         float toneSample = 0.0f;
         float fcFluc = 0.0f;
 
+        // 1 サンプルで半周期以上進む時は補正できないので素朴な波形のままにする
+        const bool useAntialias = m_antialias && phaseInc < 0.5f;
+
         if (m_waveform == 0) // Pulse
         {
             if (m_dutyFc) {
@@ -428,6 +438,14 @@ float SsgCore::getSample()
 
                 toneSample = (m_phase < currentDuty) ? 1.0f : -1.0f;
                 fcFluc = (m_phase < currentDuty) ? -m_dutyFcFluc * (m_phase / currentDuty) : m_dutyFcFluc * ((m_phase - currentDuty) / (1.0f - currentDuty));
+
+                if (useAntialias) {
+                    // 立ち上がり (位相 0) と立ち下がり (位相 duty) の段差をならす (ゆらぎの段差は逆向き)
+                    const float riseBlep = PolyBlep::step(m_phase, phaseInc);
+                    const float fallBlep = PolyBlep::step(PolyBlep::wrap(m_phase - currentDuty), phaseInc);
+                    toneSample += 2.0f * (riseBlep - fallBlep);
+                    fcFluc += m_dutyFcFluc * (fallBlep - riseBlep);
+                }
             }
             else {
                 float currentDuty = m_dutyMode == 0 ? dutyPresets[m_dutyPreset] : m_dutyVar;
@@ -440,6 +458,10 @@ float SsgCore::getSample()
                 if (currentDuty > 1.0f - minDuty) currentDuty = 1.0f - minDuty;
 
                 toneSample = (m_phase < currentDuty) ? 1.0f : -1.0f;
+
+                if (useAntialias) {
+                    toneSample += 2.0f * (PolyBlep::step(m_phase, phaseInc) - PolyBlep::step(PolyBlep::wrap(m_phase - currentDuty), phaseInc));
+                }
             }
         }
         else // Triangle
@@ -451,6 +473,12 @@ float SsgCore::getSample()
 
             if (phaseNorm < k) toneSample = -1.0f + 2.0f * (phaseNorm / k);
             else                toneSample = 1.0f - 2.0f * ((phaseNorm - k) / (1.0f - k));
+
+            if (useAntialias) {
+                // 谷 (位相 0) と頂点 (位相 k) の折れ点をならす (傾きの変化量は 1 サンプルあたりに直して掛ける)
+                const float slopeChange = 2.0f / k + 2.0f / (1.0f - k);
+                toneSample += slopeChange * phaseInc * (PolyBlep::ramp(phaseNorm, phaseInc) - PolyBlep::ramp(PolyBlep::wrap(phaseNorm - k), phaseInc));
+            }
         }
 
         m_phase += phaseInc;
@@ -489,24 +517,33 @@ float SsgCore::getSample()
         }
 
         m_lastSample = finalOut + fcFluc;
+
+        m_resampler.push(m_lastSample);
     }
 
-    // 線形補間を適用して波形を滑らかに出力する
-    float fraction = (float)(m_rateAccumulator / stepSize);
-    if (fraction > 1.0f) fraction = 1.0f;
+    float interpolatedSample;
+    if (m_resampler.isBandLimited()) {
+        // 帯域制限した補間 (ホストのレートで折り返すイメージを取り除く)
+        interpolatedSample = m_resampler.read(m_rateAccumulator);
+    }
+    else {
+        // 線形補間を適用して波形を滑らかに出力する
+        float fraction = (float)(m_rateAccumulator / stepSize);
+        if (fraction > 1.0f) fraction = 1.0f;
 
-    float interpolatedSample = m_prevSample + (m_lastSample - m_prevSample) * fraction;
+        interpolatedSample = m_prevSample + (m_lastSample - m_prevSample) * fraction;
+    }
 
-    return interpolatedSample * finalEnv * m_baseLevel * m_level * 4.0f;
+    return interpolatedSample * finalEnv * m_baseLevel * 4.0f;
 }
 
-void SsgCore::renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive)
+void SsgCore::renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive)
 {
-    float sample = getSample();
-
+    // パン・ユニゾン補正の目標値はブロックごとに1回だけ計算し、ブロック内ではサンプル単位で補間する
     // ユニゾン・ハーモニー向けに変更
     float basePanL = 1.0f;
     float basePanR = 1.0f;
+    float gainComp = 1.0f;
 
     if (m_unisonTotal > 1) {
         float spreadPos = ((float)m_unisonIndex / (float)(m_unisonTotal - 1)) * 2.0f - 1.0f; // -1.0 to 1.0
@@ -519,12 +556,28 @@ void SsgCore::renderNextBlock(float* outR, float* outL, int startSample, int sam
 
         // 音量補正 (ボイス数が増えると爆音になるため下げる)
         // ルートを取るか、単純に割るかは好みですが、単純割りの方が安全です
-        float gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
-        sample *= gainComp;
+        gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
     }
 
-    outL[startSample + sampleIdx] += sample * basePanL;
-    outR[startSample + sampleIdx] += sample * basePanR;
+    // レベルもここで掛ける (ブロック境界でゲインが段差にならないよう、目標値へ向けてなめらかに動かす)
+    m_outGain.setTarget(basePanL * gainComp * m_level, basePanR * gainComp * m_level);
+
+    isActive = true;
+
+    // レート・品質が変わった時だけ変換の設定を作り直す
+    m_resampler.configure(m_targetRate, m_sampleRate, m_resampleQuality);
+
+    for (int i = startSample; i < startSample + numSamples; ++i)
+    {
+        float sample = getSample();
 
-    isActive = isPlaying();
+        outL[i] += sample * m_outGain.left.getNextValue();
+        outR[i] += sample * m_outGain.right.getNextValue();
+
+        if (!isPlaying())
+        {
+            isActive = false;
+            break;
+        }
+    }
 }
@@ -6,18 +6,21 @@
 
 #include "../../Core/Synth/SynthParams.h"
 #include "../../Core/Synth/SynthCore.h"
+#include "../../Core/Synth/SynthSmoother.h"
+#include "../../Core/Synth/SynthResampler.h"
 #include "../../Effect/Envelope/Amp/Adsr/EnvAmpAdsr.h"
 #include "../../Effect/Envelope/Pitch/Adsr/EnvPirchAdsr.h"
 #include "../../Effect/Envelope/Amp/SsgSw/EnvSsgSw.h"
 #include "../../Effect/Envelope/Amp/SsgSw11/EnvSsgSw11.h"
 #include "../../Effect/Envelope/Pitch/SsgSw11/EnvSsgSw11.h"
 #include "../../Generator/Noise/Ssg/GenNoiseSsg.h"
+#include "../../Generator/Blep/GenBlep.h"
 #include "../../Effect/Detune/Opzx7/DetuneOpzx7.h"
 #include "../../Effect/Lfo/Opzx7/LfoOpzx7.h"
 #include "../../Generator/Fm/Fix/FmFix.h"
 #include "../../Advanced/Curve/AdvancedCurve.h"
 
-class SsgCore : public SynthCore
+class SsgCore final : public SynthCore
 {
 public:
     SsgCore();
@@ -34,7 +37,7 @@ public:
     void setModulationWheel(int wheelValue) override;
     void setPitchBendRatio(float ratio) override;
     float getSample() override;
-    void renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive) override;
+    void renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive) override;
     void setCurveCore(CurveCore* p_curveCore);
 
     // ユニゾン・ハーモニー用
@@ -52,6 +55,8 @@ private:
     double m_sampleRate = 44100.0;
 
     float m_level = 1.0f;
+    StereoGainSmoother m_outGain; // レベル・パンはここでサンプル単位に補間して掛ける
+    bool m_antialias = false; // 矩形波・三角波の段差と折れ点を PolyBLEP / PolyBLAMP でならす (設定画面の値)
 
     float m_tone = 1.0f;
     float m_noiseLevel = 0.0f;
@@ -93,6 +98,8 @@ private:
     int m_rateIndex = 1; // Default 55.5k
     double m_targetRate = 44100.0;
     double m_rateAccumulator = 0.0;
+    VirtualRateResampler m_resampler; // 仮想レートからホストのレートへの変換 (品質が Linear 以外の時)
+    int m_resampleQuality = VirtualRateResampler::Standard;
     float m_lastSample = 0.0f;
     float m_prevSample = 0.0f;
     float m_quantizeSteps = 15.0f; // Default 4bit
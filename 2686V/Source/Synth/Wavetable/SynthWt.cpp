@@ -1,6 +1,7 @@
 ﻿#include "./SynthWt.h"
 
 #include "../../Core/Synth/SynthHelpers.h"
+#include "../../Core/Synth/SynthFastMath.h"
 
 WtCore::WtCore() : SynthCore()
 {
@@ -23,7 +24,10 @@ void WtCore::setCurveCore(CurveCore* p_curveCore)
 
 void WtCore::prepare(double sampleRate)
 {
-    if (sampleRate > 0.0) m_sampleRate = sampleRate;
+    if (sampleRate > 0.0) {
+        m_sampleRate = sampleRate;
+        m_outGain.prepare(sampleRate);
+    }
 
     m_adsr.prepare(m_sampleRate);
     m_pitchAdsr.prepare(0, m_sampleRate);
@@ -118,6 +122,8 @@ void WtCore::setParameters(const SynthParams& params)
 
 void WtCore::noteOn(float freq, float velocity, int midiNote, bool isLegato)
 {
+    if (!isLegato) m_outGain.restart();
+
     // =====================================================================
     // モノフォニック・レガート時は、音量（ベロシティ）を更新しない！
     // 1音目の音量をそのまま引き継ぐことで、音量ジャンプを完全に防ぐ。
@@ -342,7 +348,7 @@ float WtCore::getSample()
         float amMultiplier = 1.0f;
         if (m_lfo.am.enable) {
             float attenDb = m_lfo.value.am * m_lfo.am.depthDb;
-            amMultiplier = std::pow(10.0f, -attenDb / 20.0f);
+            amMultiplier = FastMath::dbToGain(-attenDb);
         }
 
         // 2. Pitch Modulation (PM / 音程)
@@ -350,7 +356,7 @@ float WtCore::getSample()
         if (m_lfo.pm.enable) {
             pitchModCents += m_lfo.value.pm * m_lfo.pm.depthCent;
         }
-        float opzx7PitchMod = std::pow(2.0f, pitchModCents / 1200.0f);
+        float opzx7PitchMod = FastMath::centsToRatio(pitchModCents);
 
         // ==========================================
         // Wavetable固有の Modulation (Vibrato / Table Scan)
@@ -447,7 +453,7 @@ float WtCore::getSample()
         if (m_phase >= 1.0f) m_phase -= 1.0f;
     }
 
-    return m_lastSample * finalEnv * m_level * m_baseLevel * 8.0f;
+    return m_lastSample * finalEnv * m_baseLevel * 8.0f;
  }
 
 // 波形データ生成
@@ -506,13 +512,13 @@ void WtCore::updatePhaseDelta()
     m_phaseDelta = m_currentFrequency / m_targetRate;
 }
 
-void WtCore::renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive)
+void WtCore::renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive)
 {
-    float sample = getSample();
-
+    // パン・ユニゾン補正の目標値はブロックごとに1回だけ計算し、ブロック内ではサンプル単位で補間する
     // ユニゾン・ハーモニー向けに変更
     float basePanL = 1.0f;
     float basePanR = 1.0f;
+    float gainComp = 1.0f;
 
     if (m_unisonTotal > 1) {
         float spreadPos = ((float)m_unisonIndex / (float)(m_unisonTotal - 1)) * 2.0f - 1.0f; // -1.0 to 1.0
@@ -525,12 +531,25 @@ void WtCore::renderNextBlock(float* outR, float* outL, int startSample, int samp
 
         // 音量補正 (ボイス数が増えると爆音になるため下げる)
         // ルートを取るか、単純に割るかは好みですが、単純割りの方が安全です
-        float gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
-        sample *= gainComp;
+        gainComp = 1.0f / std::sqrt((float)m_unisonTotal);
     }
 
-    outL[startSample + sampleIdx] += sample * basePanL;
-    outR[startSample + sampleIdx] += sample * basePanR;
+    // レベルもここで掛ける (ブロック境界でゲインが段差にならないよう、目標値へ向けてなめらかに動かす)
+    m_outGain.setTarget(basePanL * gainComp * m_level, basePanR * gainComp * m_level);
+
+    isActive = true;
+
+    for (int i = startSample; i < startSample + numSamples; ++i)
+    {
+        float sample = getSample();
 
-    isActive = isPlaying();
+        outL[i] += sample * m_outGain.left.getNextValue();
+        outR[i] += sample * m_outGain.right.getNextValue();
+
+        if (!isPlaying())
+        {
+            isActive = false;
+            break;
+        }
+    }
 }
@@ -6,6 +6,7 @@
 #include <cmath>
 
 #include "../../Core/Synth/SynthCore.h"
+#include "../../Core/Synth/SynthSmoother.h"
 #include "../../Core/Synth/SynthParams.h"
 #include "../../Effect/Envelope/Amp/Adsr/EnvAmpAdsr.h"
 #include "../../Effect/Envelope/Pitch/Adsr/EnvPirchAdsr.h"
@@ -17,7 +18,7 @@
 #include "../../Generator/Fm/Fix/FmFix.h"
 #include "../../Advanced/Curve/AdvancedCurve.h"
 
-class Wt2Core : public SynthCore
+class Wt2Core final : public SynthCore
 {
 public:
     Wt2Core();
@@ -32,7 +33,7 @@ public:
     void setModulationWheel(int wheelValue) override;
     void setPitchBendRatio(float ratio) override;
     float getSample() override;
-    void renderNextBlock(float* outR, float* outL, int startSample, int sampleIdx, bool& isActive) override;
+    void renderNextBlock(float* outR, float* outL, int startSample, int numSamples, bool& isActive) override;
     void setCurveCore(CurveCore* p_curveCore);
 
     // ユニゾン・ハーモニー用
@@ -62,6 +63,7 @@ private:
     SsgSwPEnv11 m_ssgSwPenv11;
 
     float m_level = 1.0f;
+    StereoGainSmoother m_outGain; // レベル・パンはここでサンプル単位に補間して掛ける
 
     // Wave Data
     std::vector<float> m_sourceWave; // Internal High-Res (Length 64)
@@ -0,0 +1,391 @@
+﻿// 2686VBench: 各 SynthCore / FxCore を単体で鳴らし、1サンプルあたりの処理時間を計測するコンソールツール
+//
+// 使い方:
+//   2686VBench [--preset foo.xml] [--seconds 5] [--rate 48000] [--block 512] [--filter OPZX7] [--threads 3]
+//
+// オプション:
+//   --preset <file>    コアのパラメータを取るプリセット (省略時は初期値)
+//   --seconds <sec>    1項目あたりのレンダリング時間 (既定 5)
+//   --rate <hz>        サンプルレート (既定 48000)
+//   --block <n>        ブロックサイズ (既定 512)
+//   --filter <text>    名前にこの文字列を含む項目だけ計測する
+//   --threads <n>      Pool 項目で比べるボイス描画の作業スレッド数 (既定 3)
+//
+// シンセは 1 ボイス分 (A4, ベロシティ最大) を鳴らし続け、発音が終わったら打ち直す
+// FX はホワイトノイズのステレオバッファを処理する
+// Pool はプロセッサごと OPZX7 の 10 音 x ユニゾン 8 の和音を鳴らし、作業スレッド 0 と n を比べる
+// ns/sample はステレオ 1 フレームあたりの時間
+
+#include <JuceHeader.h>
+#include <iostream>
+
+#include "../../Source/Core/Processor/PluginProcessor.h"
+#include "../../Source/Core/Synth/SynthHelpers.h"
+
+namespace
+{
+    struct BenchSettings
+    {
+        juce::File presetFile;
+        double seconds = 5.0;
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        juce::String filter;
+        int threads = 3;
+    };
+
+    struct BenchResult
+    {
+        juce::int64 samples = 0;
+        double seconds = 0.0;
+        int retriggers = 0;
+
+        double getNsPerSample() const { return samples > 0 ? seconds * 1.0e9 / (double)samples : 0.0; }
+    };
+
+    constexpr int benchNote = 69; // A4
+    constexpr double sampleSourceRate = 44100.0;
+    constexpr double sampleSeconds = 2.0;
+    constexpr int curveBakeTimeoutMs = 10000; // カーブの焼き込み (ワーカースレッド) を待つ上限
+    constexpr int poolChordRoot = 48;         // Pool 項目の和音は C3 から 3 半音ずつ Global::voices 音重ねる
+    constexpr double poolRetriggerSeconds = 1.0;
+
+    // ADPCM / Rhythm 用のサンプル (減衰するノイズ混じりのサイン波)
+    PcmSample::Ptr makeBenchSample()
+    {
+        PcmSample::Ptr sample = new PcmSample();
+        sample->path = "(bench)";
+        sample->sourceRate = sampleSourceRate;
+
+        juce::Random random(2686);
+        int length = (int)(sampleSourceRate * sampleSeconds);
+        sample->raw.resize((size_t)length);
+
+        for (int i = 0; i < length; ++i)
+        {
+            float t = (float)i / (float)sampleSourceRate;
+            float env = std::exp(-2.0f * t);
+            sample->raw[(size_t)i] = env * (0.7f * std::sin(juce::MathConstants<float>::twoPi * 220.0f * t) + 0.3f * (random.nextFloat() * 2.0f - 1.0f));
+        }
+
+        return sample;
+    }
+
+    template <typename Core>
+    std::unique_ptr<Core> makeCore(CurveCore* curveCore, double sampleRate, const SynthParams& params)
+    {
+        auto core = std::make_unique<Core>();
+        core->setCurveCore(curveCore);
+        core->prepare(sampleRate);
+        core->setParameters(params);
+        return core;
+    }
+
+    BenchResult runCore(SynthCore& core, const BenchSettings& settings)
+    {
+        juce::AudioBuffer<float> buffer(2, settings.blockSize);
+        auto totalSamples = (juce::int64)(settings.seconds * settings.sampleRate);
+
+        float freq = (float)juce::MidiMessage::getMidiNoteInHertz(benchNote);
+        core.noteOn(freq, 1.0f, benchNote);
+
+        BenchResult result;
+        juce::int64 ticks = 0;
+
+        for (juce::int64 pos = 0; pos < totalSamples; pos += settings.blockSize)
+        {
+            int numSamples = (int)std::min<juce::int64>(settings.blockSize, totalSamples - pos);
+            buffer.clear();
+
+            bool isActive = false;
+
+            auto start = juce::Time::getHighResolutionTicks();
+            core.renderNextBlock(buffer.getWritePointer(1), buffer.getWritePointer(0), 0, numSamples, isActive);
+            ticks += juce::Time::getHighResolutionTicks() - start;
+
+            // 減衰しきったら打ち直す (無音区間を計測しないため)
+            if (!isActive) {
+                core.noteOn(freq, 1.0f, benchNote);
+                ++result.retriggers;
+            }
+        }
+
+        result.samples = totalSamples;
+        result.seconds = juce::Time::highResolutionTicksToSeconds(ticks);
+
+        return result;
+    }
+
+    // fx は prepare 済みであること (遅延時間などは prepare のレートで計算される)
+    BenchResult runFx(FxCore& fx, const BenchSettings& settings)
+    {
+        juce::AudioBuffer<float> source(2, settings.blockSize);
+        juce::AudioBuffer<float> buffer(2, settings.blockSize);
+        juce::Random random(2686);
+
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int i = 0; i < settings.blockSize; ++i) {
+                source.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+            }
+        }
+
+        auto totalSamples = (juce::int64)(settings.seconds * settings.sampleRate);
+
+        BenchResult result;
+        juce::int64 ticks = 0;
+
+        for (juce::int64 pos = 0; pos < totalSamples; pos += settings.blockSize)
+        {
+            int numSamples = (int)std::min<juce::int64>(settings.blockSize, totalSamples - pos);
+            buffer.setSize(2, numSamples, false, false, true);
+            for (int ch = 0; ch < 2; ++ch) buffer.copyFrom(ch, 0, source, ch, 0, numSamples);
+
+            auto start = juce::Time::getHighResolutionTicks();
+            fx.process(buffer);
+            ticks += juce::Time::getHighResolutionTicks() - start;
+        }
+
+        result.samples = totalSamples;
+        result.seconds = juce::Time::highResolutionTicksToSeconds(ticks);
+
+        return result;
+    }
+
+    void setParameter(AudioPlugin2686V& processor, const juce::String& id, float value)
+    {
+        if (auto* param = processor.apvts.getParameter(id)) {
+            param->setValueNotifyingHost(param->getNormalisableRange().convertTo0to1(value));
+        }
+    }
+
+    // プロセッサの processBlock ごと計測する (和音を poolRetriggerSeconds ごとに打ち直す)
+    BenchResult runProcessor(AudioPlugin2686V& processor, const BenchSettings& settings)
+    {
+        processor.prepareToPlay(settings.sampleRate, settings.blockSize);
+
+        juce::AudioBuffer<float> buffer(2, settings.blockSize);
+        juce::MidiBuffer midi;
+        auto totalSamples = (juce::int64)(settings.seconds * settings.sampleRate);
+        auto retriggerSamples = (juce::int64)(poolRetriggerSeconds * settings.sampleRate);
+        juce::int64 nextTrigger = 0;
+
+        BenchResult result;
+        juce::int64 ticks = 0;
+
+        for (juce::int64 pos = 0; pos < totalSamples; pos += settings.blockSize)
+        {
+            int numSamples = (int)std::min<juce::int64>(settings.blockSize, totalSamples - pos);
+            buffer.setSize(2, numSamples, false, false, true);
+            buffer.clear();
+            midi.clear();
+
+            if (pos >= nextTrigger) {
+                for (int i = 0; i < Global::voices; ++i) {
+                    int note = poolChordRoot + i * 3;
+                    if (pos > 0) midi.addEvent(juce::MidiMessage::noteOff(1, note), 0);
+                    midi.addEvent(juce::MidiMessage::noteOn(1, note, 1.0f), 0);
+                }
+                if (pos > 0) ++result.retriggers;
+                nextTrigger += retriggerSamples;
+            }
+
+            auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            ticks += juce::Time::getHighResolutionTicks() - start;
+        }
+
+        processor.releaseResources();
+
+        result.samples = totalSamples;
+        result.seconds = juce::Time::highResolutionTicksToSeconds(ticks);
+
+        return result;
+    }
+
+    void printHeader()
+    {
+        std::cout << "name              ns/sample   realtime  retriggers" << std::endl;
+    }
+
+    void printResult(const juce::String& name, const BenchSettings& settings, const BenchResult& result)
+    {
+        double realtime = result.seconds > 0.0 ? ((double)result.samples / settings.sampleRate) / result.seconds : 0.0;
+
+        std::cout << name.paddedRight(' ', 16)
+                  << juce::String(result.getNsPerSample(), 2).paddedLeft(' ', 11)
+                  << juce::String(realtime, 1).paddedLeft(' ', 11)
+                  << juce::String(result.retriggers).paddedLeft(' ', 12)
+                  << std::endl;
+    }
+
+    bool isSelected(const BenchSettings& settings, const juce::String& name)
+    {
+        return settings.filter.isEmpty() || name.containsIgnoreCase(settings.filter);
+    }
+
+    void benchSynthCores(AudioPlugin2686V& processor, const BenchSettings& settings)
+    {
+        auto* curveCore = processor.getCurveCore();
+        auto sample = makeBenchSample();
+
+        for (int m = 0; m < (int)OscMode::Count; ++m)
+        {
+            auto mode = (OscMode)m;
+            auto name = getModeName(mode);
+            if (!isSelected(settings, name)) continue;
+
+            auto params = processor.buildSynthParams(mode);
+            std::unique_ptr<SynthCore> core;
+
+            switch (mode)
+            {
+            case OscMode::OPNA:      core = makeCore<OpnaCore>(curveCore, settings.sampleRate, params); break;
+            case OscMode::OPN:       core = makeCore<OpnCore>(curveCore, settings.sampleRate, params); break;
+            case OscMode::OPL:       core = makeCore<OplCore>(curveCore, settings.sampleRate, params); break;
+            case OscMode::OPL3:      core = makeCore<Opl3Core>(curveCore, settings.sampleRate, params); break;
+            case OscMode::OPM:       core = makeCore<OpmCore>(curveCore, settings.sampleRate, params); break;
+            case OscMode::OPZX7:     core = makeCore<Opzx7Core>(curveCore, settings.sampleRate, params); break;
+            case OscMode::SSG:       core = makeCore<SsgCore>(curveCore, settings.sampleRate, params); break;
+            case OscMode::WAVETABLE: core = makeCore<WtCore>(curveCore, settings.sampleRate, params); break;
+            case OscMode::WT2:       core = makeCore<Wt2Core>(curveCore, settings.sampleRate, params); break;
+            case OscMode::BEEP:      core = makeCore<BeepCore>(curveCore, settings.sampleRate, params); break;
+            case OscMode::ADPCM:
+            {
+                const auto& quality = params.adpcm.quality;
+                GenPcmPool::prepareEncoded(*sample, quality.mode, getTargetRate(quality.rate, 16000.0f));
+
+                auto adpcm = makeCore<AdpcmCore>(curveCore, settings.sampleRate, params);
+                adpcm->setSampleData(sample.get());
+                core = std::move(adpcm);
+                break;
+            }
+            case OscMode::RHYTHM:
+            {
+                auto rhythm = makeCore<RhythmCore>(curveCore, settings.sampleRate, params);
+                for (int pad = 0; pad < RhythmPrValue::pads; ++pad) {
+                    const auto& quality = params.rhythm.pads[pad].quality;
+                    GenPcmPool::prepareEncoded(*sample, quality.mode, getTargetRate(quality.rate));
+                    rhythm->setSampleData(pad, sample.get());
+                }
+                core = std::move(rhythm);
+                break;
+            }
+            default: break;
+            }
+
+            if (core != nullptr) printResult(name, settings, runCore(*core, settings));
+        }
+    }
+
+    void benchFx(const BenchSettings& settings)
+    {
+        // パラメータは代表的な値で固定する (Mix は 100% 側に寄せてウェット経路を必ず通す)
+        FxFilter filter;
+        FxEq3b eq3b;
+        FxTremolo tremolo;
+        FxVibrato vibrato;
+        FxMBC bitCrusher;
+        FxDelay delay;
+        FxReverb reverb;
+        FxSfcEcho sfcEcho;
+
+        const std::array<std::pair<juce::String, FxCore*>, (int)FxType::Count> fxs{ {
+            { "Fx:Filter", &filter },
+            { "Fx:Eq3b", &eq3b },
+            { "Fx:Tremolo", &tremolo },
+            { "Fx:Vibrato", &vibrato },
+            { "Fx:BitCrusher", &bitCrusher },
+            { "Fx:Delay", &delay },
+            { "Fx:Reverb", &reverb },
+            { "Fx:SfcEcho", &sfcEcho },
+        } };
+
+        // 遅延時間はサンプルレートから計算されるので、prepare してからパラメータを渡す
+        for (const auto& [name, fx] : fxs) fx->prepare(settings.sampleRate);
+
+        filter.setParameters(0.0f, 1000.0f, 0.707f, 1.0f);
+        eq3b.setParameters(3.0f, 1000.0f, -3.0f, 2.0f, 1.0f);
+        tremolo.setParameters(5.0f, 0.5f, 1.0f);
+        vibrato.setParameters(5.0f, 0.5f, 1.0f);
+        bitCrusher.setParameters(4.0f, 8.0f, 1.0f);
+        delay.setParameters(250.0f, 0.4f, 1.0f);
+        reverb.setParameters(0.7f, 0.5f, 1.0f, 1.0f);
+        sfcEcho.setParameters(200.0f, 0.5f, 1.0f);
+
+        for (const auto& [name, fx] : fxs)
+        {
+            if (isSelected(settings, name)) printResult(name, settings, runFx(*fx, settings));
+        }
+    }
+
+    // VoiceRenderPool の効果を見る (作業スレッド無しと settings.threads 本で同じ和音を鳴らす)
+    void benchRenderPool(AudioPlugin2686V& processor, const BenchSettings& settings)
+    {
+        const juce::String name = "Pool:OPZX7";
+        if (!isSelected(settings, name)) return;
+
+        setParameter(processor, CPK::mode, (float)OscMode::OPZX7);
+        setParameter(processor, Opzx7PrKey::prefix + CPK::Unison::voices, (float)Global::unisonVoices);
+
+        const int restoreThreads = processor.getRenderThreads();
+
+        for (int threads : { 0, settings.threads })
+        {
+            processor.setRenderThreads(threads);
+            printResult(name + " t" + juce::String(processor.getRenderThreads()), settings, runProcessor(processor, settings));
+        }
+
+        processor.setRenderThreads(restoreThreads);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "usage: 2686VBench [--preset file.xml] [--seconds sec] [--rate hz] [--block n] [--filter text] [--threads n]" << std::endl;
+        return 0;
+    }
+
+    BenchSettings settings;
+
+    if (args.containsOption("--preset")) settings.presetFile = args.getFileForOption("--preset");
+    if (args.containsOption("--seconds")) settings.seconds = args.getValueForOption("--seconds").getDoubleValue();
+    if (args.containsOption("--rate")) settings.sampleRate = args.getValueForOption("--rate").getDoubleValue();
+    if (args.containsOption("--block")) settings.blockSize = std::max(1, args.getValueForOption("--block").getIntValue());
+    if (args.containsOption("--filter")) settings.filter = args.getValueForOption("--filter");
+    if (args.containsOption("--threads")) settings.threads = std::clamp(args.getValueForOption("--threads").getIntValue(), Global::RenderThreads::min, Global::RenderThreads::max);
+
+    if (settings.presetFile != juce::File() && !settings.presetFile.existsAsFile()) {
+        std::cerr << "file not found: " << settings.presetFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    // パラメータとカーブはプロセッサから借りる (コアはプロセッサと独立に作る)
+    AudioPlugin2686V processor;
+    if (settings.presetFile.existsAsFile())
+    {
+        processor.loadPreset(settings.presetFile);
+
+        // プリセットのカーブを焼き込ませておく
+        auto* curveCore = processor.getCurveCore();
+        curveCore->setParameters(processor.buildSynthParams(OscMode::OPNA).curve);
+
+        auto start = juce::Time::getMillisecondCounter();
+        while (!curveCore->isBaked() && juce::Time::getMillisecondCounter() - start < (juce::uint32)curveBakeTimeoutMs) {
+            juce::Thread::sleep(5);
+        }
+    }
+
+    std::cout << "rate " << (int)settings.sampleRate << " Hz, block " << settings.blockSize << ", " << settings.seconds << " s per item" << std::endl;
+    printHeader();
+
+    benchSynthCores(processor, settings);
+    benchFx(settings);
+    benchRenderPool(processor, settings);
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+﻿#include "./RenderCore.h"
+
+#include "../../Source/Core/Processor/PluginProcessor.h"
+
+namespace
+{
+    constexpr double patternStepSeconds = 1.0;    // パターンの打ち直し間隔
+    constexpr double defaultPatternSeconds = 10.0;
+    constexpr double midiTailSeconds = 1.0;       // MIDI の最後のイベント以降に鳴らしておく長さ
+    constexpr int settleTimeoutMs = 10000;        // サンプル読み込み・カーブ焼き込みを待つ上限
+
+    void setMode(AudioPlugin2686V& processor, OscMode mode)
+    {
+        if (auto* param = processor.apvts.getParameter(CPK::mode)) {
+            param->setValueNotifyingHost(param->getNormalisableRange().convertTo0to1((float)mode));
+        }
+    }
+
+    // 全トラックをまとめて、時刻を秒にした MIDI シーケンスを作る
+    bool loadMidiFile(const juce::File& file, juce::MidiMessageSequence& sequence)
+    {
+        juce::FileInputStream stream(file);
+        juce::MidiFile midiFile;
+
+        if (!stream.openedOk() || !midiFile.readFrom(stream)) return false;
+
+        midiFile.convertTimestampTicksToSeconds();
+
+        for (int i = 0; i < midiFile.getNumTracks(); ++i) {
+            sequence.addSequence(*midiFile.getTrack(i), 0.0);
+        }
+        sequence.updateMatchedPairs();
+
+        return true;
+    }
+
+    // 同時発音数 voices の和音を patternStepSeconds ごとに打ち直すパターン
+    juce::MidiMessageSequence makePattern(int voices, double seconds)
+    {
+        juce::MidiMessageSequence sequence;
+
+        int step = 0;
+        for (double t = 0.0; t < seconds; t += patternStepSeconds, ++step)
+        {
+            double offTime = std::min(t + patternStepSeconds * 0.9, seconds);
+            for (int v = 0; v < voices; ++v)
+            {
+                int note = 36 + (v * 7 + step * 2) % 60;
+                sequence.addEvent(juce::MidiMessage::noteOn(1, note, (juce::uint8)100), t);
+                sequence.addEvent(juce::MidiMessage::noteOff(1, note), offTime);
+            }
+        }
+        sequence.sort();
+
+        return sequence;
+    }
+
+    // 読み込み・焼き込みはワーカースレッドで行われるので、出揃うまで待つ
+    // (最初のブロックでパラメータをプロセッサに反映させる。回るブロック数は実行ごとに違うので、
+    //  呼び出し側で prepareToPlay し直して LFO の位相などを初期状態に戻すこと)
+    // settleTimeoutMs 以内に出揃わなければ false を返す (そのまま描画しても再現性が無い)
+    bool settle(AudioPlugin2686V& processor, int blockSize)
+    {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+
+        auto isSettled = [&processor] {
+            return !processor.pcmPool.isLoading() && processor.getCurveCore()->isBaked();
+        };
+
+        auto start = juce::Time::getMillisecondCounter();
+        do {
+            processor.processBlock(buffer, midi);
+            if (isSettled()) return true;
+            juce::Thread::sleep(5);
+        } while (juce::Time::getMillisecondCounter() - start < (juce::uint32)settleTimeoutMs);
+
+        return false;
+    }
+}
+
+namespace RenderCore
+{
+    std::optional<OscMode> parseMode(const juce::String& name)
+    {
+        for (int i = 0; i < (int)OscMode::Count; ++i) {
+            if (getModeName((OscMode)i).equalsIgnoreCase(name.trim())) return (OscMode)i;
+        }
+        return std::nullopt;
+    }
+
+    RenderResult render(const RenderSettings& settings, juce::AudioFormatWriter* writer, juce::AudioBuffer<float>* capture)
+    {
+        AudioPlugin2686V processor;
+
+        if (settings.presetFile.existsAsFile()) processor.loadPreset(settings.presetFile);
+        if (settings.mode.has_value()) setMode(processor, *settings.mode);
+
+        juce::MidiMessageSequence sequence;
+        double seconds = settings.seconds;
+
+        if (settings.midiFile != juce::File())
+        {
+            if (!loadMidiFile(settings.midiFile, sequence)) {
+                RenderResult failed;
+                failed.error = "cannot read MIDI file: " + settings.midiFile.getFullPathName();
+                return failed;
+            }
+            if (seconds <= 0.0) seconds = sequence.getEndTime() + midiTailSeconds;
+        }
+        else
+        {
+            if (seconds <= 0.0) seconds = defaultPatternSeconds;
+            sequence = makePattern(settings.voices, seconds);
+        }
+
+        processor.setPlayConfigDetails(0, 2, settings.sampleRate, settings.blockSize);
+        processor.prepareToPlay(settings.sampleRate, settings.blockSize);
+
+        if (!settle(processor, settings.blockSize)) {
+            processor.releaseResources();
+
+            RenderResult failed;
+            failed.error = "timed out waiting for samples to load and curves to bake";
+            return failed;
+        }
+
+        // 待っている間に進んだ DSP の状態 (トレモロ・ビブラートの位相、ディレイの残響など) を捨て、毎回同じ状態から始める
+        processor.prepareToPlay(settings.sampleRate, settings.blockSize);
+
+        juce::AudioBuffer<float> buffer(2, settings.blockSize);
+        juce::MidiBuffer midi;
+
+        auto totalSamples = (juce::int64)std::ceil(seconds * settings.sampleRate);
+        int eventIndex = 0;
+
+        if (capture != nullptr) capture->setSize(2, (int)totalSamples);
+
+        RenderResult result;
+        result.audioSeconds = (double)totalSamples / settings.sampleRate;
+
+        juce::int64 processTicks = 0;
+
+        for (juce::int64 pos = 0; pos < totalSamples; pos += settings.blockSize)
+        {
+            int numSamples = (int)std::min<juce::int64>(settings.blockSize, totalSamples - pos);
+            double blockEnd = (double)(pos + numSamples) / settings.sampleRate;
+
+            midi.clear();
+            while (eventIndex < sequence.getNumEvents())
+            {
+                const auto& message = sequence.getEventPointer(eventIndex)->message;
+                if (message.getTimeStamp() >= blockEnd) break;
+
+                int offset = (int)(message.getTimeStamp() * settings.sampleRate - (double)pos);
+                midi.addEvent(message, juce::jlimit(0, numSamples - 1, offset));
+                ++eventIndex;
+            }
+
+            buffer.setSize(2, numSamples, false, false, true);
+
+            // 計測するのは processBlock のみ (WAV 書き出しは含めない)
+            auto startTicks = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            processTicks += juce::Time::getHighResolutionTicks() - startTicks;
+
+            result.peak = std::max(result.peak, buffer.getMagnitude(0, numSamples));
+
+            if (writer != nullptr) writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+
+            if (capture != nullptr) {
+                for (int ch = 0; ch < 2; ++ch) capture->copyFrom(ch, (int)pos, buffer, ch, 0, numSamples);
+            }
+        }
+
+        processor.releaseResources();
+
+        result.wallSeconds = juce::Time::highResolutionTicksToSeconds(processTicks);
+
+        return result;
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> createWavWriter(const juce::File& file, double sampleRate, int bitsPerSample)
+    {
+        file.getParentDirectory().createDirectory();
+        file.deleteFile();
+
+        auto stream = std::make_unique<juce::FileOutputStream>(file);
+        if (!stream->openedOk()) return nullptr;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, 2, bitsPerSample, {}, 0));
+        if (writer != nullptr) stream.release(); // 以降はライターがストリームを持つ
+
+        return writer;
+    }
+}
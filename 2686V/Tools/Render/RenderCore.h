@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <JuceHeader.h>
+#include <optional>
+
+#include "../../Source/Core/Synth/SynthMode.h"
+
+// 2686VRender の共通部分: プリセット + MIDI/パターンを processBlock で回す
+
+struct RenderSettings
+{
+    juce::File presetFile;
+    juce::File midiFile;
+    juce::File outFile;
+    std::optional<OscMode> mode;
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    int voices = 4;
+    double seconds = 0.0;
+};
+
+struct RenderResult
+{
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0; // processBlock にかかった時間のみ
+    float peak = 0.0f;
+    juce::String error; // 空でなければ失敗 (何もレンダリングしていない)
+
+    double getRealtimeFactor() const { return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0; }
+};
+
+namespace RenderCore
+{
+    std::optional<OscMode> parseMode(const juce::String& name);
+
+    // writer / capture はどちらも省略可 (capture は出力全体の長さにリサイズされる)
+    RenderResult render(const RenderSettings& settings, juce::AudioFormatWriter* writer, juce::AudioBuffer<float>* capture);
+
+    // bitsPerSample が 32 の時は浮動小数点で書く
+    std::unique_ptr<juce::AudioFormatWriter> createWavWriter(const juce::File& file, double sampleRate, int bitsPerSample);
+}
@@ -0,0 +1,259 @@
+﻿#include "./RenderGolden.h"
+
+#include <iostream>
+#include <optional>
+
+#include "../../Source/Gui/Preset/PresetValues.h"
+
+namespace
+{
+    enum class CompareMode { BitExact, Rms, Spectral };
+
+    struct Tolerance
+    {
+        CompareMode mode = CompareMode::Rms;
+        double limit = -90.0;
+    };
+
+    struct Comparison
+    {
+        bool passed = false;
+        double value = 0.0;
+        juce::String message;
+    };
+
+    constexpr double goldenSeconds = 4.0;   // --seconds 省略時の1プリセットあたりの長さ
+    constexpr int goldenBits = 32;          // 基準は float で保存する (量子化で差が埋もれないように)
+    constexpr double defaultRmsLimitDb = -90.0;
+    constexpr double defaultSpectralLimitDb = 0.5;
+
+    constexpr int spectralOrder = 11;       // 2048 点
+    constexpr int spectralSize = 1 << spectralOrder;
+    constexpr int spectralHop = spectralSize / 2;
+    constexpr float spectralFloorDb = -100.0f; // これより小さいビンは両方とも無音として扱う
+
+    double toDb(double gain)
+    {
+        return gain > 0.0 ? 20.0 * std::log10(gain) : -std::numeric_limits<double>::infinity();
+    }
+
+    double getRms(const juce::AudioBuffer<float>& buffer)
+    {
+        double sum = 0.0;
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+            auto* data = buffer.getReadPointer(ch);
+            for (int i = 0; i < buffer.getNumSamples(); ++i) sum += (double)data[i] * (double)data[i];
+        }
+
+        auto count = (double)buffer.getNumChannels() * (double)buffer.getNumSamples();
+        return count > 0.0 ? std::sqrt(sum / count) : 0.0;
+    }
+
+    Comparison compareBitExact(const juce::AudioBuffer<float>& ref, const juce::AudioBuffer<float>& test)
+    {
+        juce::int64 diffs = 0;
+        for (int ch = 0; ch < ref.getNumChannels(); ++ch) {
+            auto* a = ref.getReadPointer(ch);
+            auto* b = test.getReadPointer(ch);
+            for (int i = 0; i < ref.getNumSamples(); ++i) {
+                if (a[i] != b[i]) ++diffs;
+            }
+        }
+
+        return { diffs == 0, (double)diffs, juce::String(diffs) + " samples differ" };
+    }
+
+    Comparison compareRms(const juce::AudioBuffer<float>& ref, const juce::AudioBuffer<float>& test, double limitDb)
+    {
+        juce::AudioBuffer<float> diff(test);
+        for (int ch = 0; ch < diff.getNumChannels(); ++ch) {
+            diff.addFrom(ch, 0, ref, ch, 0, ref.getNumSamples(), -1.0f);
+        }
+
+        double refRms = getRms(ref);
+        double diffRms = getRms(diff);
+
+        // 基準が無音なら絶対値で比べる
+        double value = refRms > 0.0 ? toDb(diffRms / refRms) : toDb(diffRms);
+
+        return { value <= limitDb, value, "rms " + juce::String(value, 1) + " dB" };
+    }
+
+    Comparison compareSpectral(const juce::AudioBuffer<float>& ref, const juce::AudioBuffer<float>& test, double limitDb)
+    {
+        juce::dsp::FFT fft(spectralOrder);
+        juce::dsp::WindowingFunction<float> window((size_t)spectralSize, juce::dsp::WindowingFunction<float>::hann, false);
+
+        std::vector<float> a((size_t)spectralSize * 2), b((size_t)spectralSize * 2);
+        double sum = 0.0;
+        juce::int64 bins = 0;
+
+        for (int ch = 0; ch < ref.getNumChannels(); ++ch)
+        {
+            for (int pos = 0; pos + spectralSize <= ref.getNumSamples(); pos += spectralHop)
+            {
+                std::fill(a.begin(), a.end(), 0.0f);
+                std::fill(b.begin(), b.end(), 0.0f);
+                std::copy_n(ref.getReadPointer(ch, pos), spectralSize, a.begin());
+                std::copy_n(test.getReadPointer(ch, pos), spectralSize, b.begin());
+
+                window.multiplyWithWindowingTable(a.data(), (size_t)spectralSize);
+                window.multiplyWithWindowingTable(b.data(), (size_t)spectralSize);
+
+                fft.performFrequencyOnlyForwardTransform(a.data(), true);
+                fft.performFrequencyOnlyForwardTransform(b.data(), true);
+
+                for (int k = 0; k <= spectralSize / 2; ++k)
+                {
+                    float da = juce::Decibels::gainToDecibels(a[(size_t)k] / (float)spectralSize, spectralFloorDb);
+                    float db = juce::Decibels::gainToDecibels(b[(size_t)k] / (float)spectralSize, spectralFloorDb);
+                    if (da <= spectralFloorDb && db <= spectralFloorDb) continue;
+
+                    sum += (double)(da - db) * (double)(da - db);
+                    ++bins;
+                }
+            }
+        }
+
+        double value = bins > 0 ? std::sqrt(sum / (double)bins) : 0.0;
+
+        return { value <= limitDb, value, "spectral " + juce::String(value, 2) + " dB" };
+    }
+
+    Comparison compare(const juce::AudioBuffer<float>& ref, const juce::AudioBuffer<float>& test, const Tolerance& tolerance)
+    {
+        if (ref.getNumChannels() != test.getNumChannels() || ref.getNumSamples() != test.getNumSamples()) {
+            return { false, 0.0, "length mismatch (" + juce::String(ref.getNumSamples()) + " / " + juce::String(test.getNumSamples()) + ")" };
+        }
+
+        switch (tolerance.mode)
+        {
+        case CompareMode::BitExact: return compareBitExact(ref, test);
+        case CompareMode::Spectral: return compareSpectral(ref, test, tolerance.limit);
+        case CompareMode::Rms:
+        default:                    return compareRms(ref, test, tolerance.limit);
+        }
+    }
+
+    bool readWav(juce::AudioFormatManager& formatManager, const juce::File& file, juce::AudioBuffer<float>& buffer, double& sampleRate)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr) return false;
+
+        buffer.setSize((int)reader->numChannels, (int)reader->lengthInSamples);
+        reader->read(&buffer, 0, (int)reader->lengthInSamples, 0, true, true);
+        sampleRate = reader->sampleRate;
+
+        return true;
+    }
+
+    std::optional<Tolerance> parseTolerance(const juce::ArgumentList& args)
+    {
+        Tolerance tolerance;
+        auto mode = args.getValueForOption("--compare");
+
+        if (mode.isEmpty() || mode.equalsIgnoreCase("rms")) {
+            tolerance = { CompareMode::Rms, defaultRmsLimitDb };
+        }
+        else if (mode.equalsIgnoreCase("spectral")) {
+            tolerance = { CompareMode::Spectral, defaultSpectralLimitDb };
+        }
+        else if (mode.equalsIgnoreCase("bitexact")) {
+            tolerance = { CompareMode::BitExact, 0.0 };
+        }
+        else {
+            return std::nullopt;
+        }
+
+        if (args.containsOption("--tolerance")) {
+            tolerance.limit = args.getValueForOption("--tolerance").getDoubleValue();
+        }
+
+        return tolerance;
+    }
+}
+
+namespace RenderGolden
+{
+    int run(const RenderSettings& base, const juce::ArgumentList& args)
+    {
+        auto goldenDir = args.getFileForOption("--golden");
+        auto corpusDir = args.containsOption("--corpus") ? args.getFileForOption("--corpus") : juce::File();
+        bool update = args.containsOption("--update");
+
+        if (!corpusDir.isDirectory()) {
+            std::cerr << "corpus folder not found: " << corpusDir.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        auto tolerance = parseTolerance(args);
+        if (!tolerance.has_value()) {
+            std::cerr << "unknown compare mode: " << args.getValueForOption("--compare") << std::endl;
+            return 1;
+        }
+
+        auto presets = corpusDir.findChildFiles(juce::File::findFiles, true, PresetValue::File::glob);
+        presets.sort(); // 出力順を安定させる
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        int passed = 0, failed = 0, updated = 0;
+
+        for (const auto& preset : presets)
+        {
+            auto relative = preset.getRelativePathFrom(corpusDir);
+            auto goldenFile = goldenDir.getChildFile(relative).withFileExtension("wav");
+
+            auto settings = base;
+            settings.presetFile = preset;
+            if (settings.seconds <= 0.0 && settings.midiFile == juce::File()) settings.seconds = goldenSeconds;
+
+            juce::AudioBuffer<float> rendered;
+            auto renderResult = RenderCore::render(settings, nullptr, &rendered);
+            if (renderResult.error.isNotEmpty()) {
+                std::cout << "ERROR   " << relative << "  " << renderResult.error << std::endl;
+                ++failed;
+                continue;
+            }
+
+            if (update)
+            {
+                auto writer = RenderCore::createWavWriter(goldenFile, settings.sampleRate, goldenBits);
+                if (writer == nullptr || !writer->writeFromAudioSampleBuffer(rendered, 0, rendered.getNumSamples())) {
+                    std::cout << "ERROR   " << relative << "  cannot write " << goldenFile.getFullPathName() << std::endl;
+                    ++failed;
+                    continue;
+                }
+
+                std::cout << "UPDATE  " << relative << std::endl;
+                ++updated;
+                continue;
+            }
+
+            juce::AudioBuffer<float> reference;
+            double referenceRate = 0.0;
+            if (!goldenFile.existsAsFile() || !readWav(formatManager, goldenFile, reference, referenceRate)) {
+                std::cout << "FAIL    " << relative << "  no reference" << std::endl;
+                ++failed;
+                continue;
+            }
+
+            if (referenceRate != settings.sampleRate) {
+                std::cout << "FAIL    " << relative << "  sample rate mismatch (" << referenceRate << ")" << std::endl;
+                ++failed;
+                continue;
+            }
+
+            auto result = compare(reference, rendered, *tolerance);
+            std::cout << (result.passed ? "PASS    " : "FAIL    ") << relative << "  " << result.message << std::endl;
+
+            if (result.passed) ++passed;
+            else ++failed;
+        }
+
+        std::cout << passed << " passed, " << failed << " failed, " << updated << " updated" << std::endl;
+
+        return failed > 0 ? 1 : 0;
+    }
+}
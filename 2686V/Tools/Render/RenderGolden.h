@@ -0,0 +1,23 @@
+﻿#pragma once
+
+#include <JuceHeader.h>
+
+#include "./RenderCore.h"
+
+// ゴールデン (基準) レンダリングとの比較
+// プリセットのコーパスをすべてレンダリングし、保存済みの基準 WAV と比べる
+//
+//   2686VRender --golden <基準WAVのフォルダ> --corpus <プリセットのフォルダ> [--update]
+//               [--compare bitexact|rms|spectral] [--tolerance <値>]
+//
+//   bitexact  全サンプルが一致すること
+//   rms       差分の RMS が基準の RMS に対して tolerance dB 以下 (既定 -90)
+//   spectral  フレームごとの対数スペクトルの差の RMS が tolerance dB 以下 (既定 0.5, 位相の違いは無視)
+//
+// --update を付けると基準 WAV を書き直す (無い物だけでなく全て)
+// 基準は 32bit float の WAV で、コーパスと同じフォルダ構成で保存する
+// 1つでも失敗すると終了コード 1 を返す
+namespace RenderGolden
+{
+    int run(const RenderSettings& base, const juce::ArgumentList& args);
+}
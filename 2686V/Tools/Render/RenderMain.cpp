@@ -0,0 +1,178 @@
+﻿// 2686VRender: DAW を使わずに AudioPlugin2686V::processBlock を回すコンソールツール
+//
+// 使い方:
+//   2686VRender --preset foo.xml --midi song.mid --out out.wav
+//   2686VRender --preset foo.xml --voices 8 --seconds 10 --out out.wav
+//   2686VRender --bench --preset foo.xml --modes all --voices 1,8,16 --rates 44100,96000
+//   2686VRender --golden golden/ --corpus presets/ --compare spectral   (RenderGolden.h を参照)
+//
+// オプション:
+//   --preset <file>    読み込むプリセット (省略時は起動時設定のまま)
+//   --midi <file>      再生する MIDI ファイル (省略時はスクリプトのノートパターン)
+//   --out <file>       書き出す WAV (ベンチマーク時は省略可)
+//   --mode <name>      モードを上書き (OPNA, OPN, ..., BEEP)
+//   --rate <hz>        サンプルレート (既定 48000)
+//   --block <n>        ブロックサイズ (既定 512)
+//   --voices <n>       パターンの同時発音数 (既定 4)
+//   --seconds <sec>    レンダリング時間 (MIDI 時は省略するとファイル長 + 1 秒)
+//   --bench            --modes / --voices / --rates の全組み合わせを計測して表示する
+//   --modes <list>     ベンチマークするモード (カンマ区切り, all で全モード)
+//   --rates <list>     ベンチマークするサンプルレート (カンマ区切り)
+//   --golden <dir>     コーパスのプリセットをレンダリングし、基準 WAV と比較する
+//
+// 実時間比 (realtime factor) = レンダリングした音声の長さ / かかった時間
+
+#include <JuceHeader.h>
+#include <iostream>
+
+#include "./RenderCore.h"
+#include "./RenderGolden.h"
+
+namespace
+{
+    std::vector<int> parseIntList(const juce::String& text)
+    {
+        std::vector<int> values;
+        for (auto& token : juce::StringArray::fromTokens(text, ",", ""))
+        {
+            if (token.trim().isNotEmpty()) values.push_back(token.trim().getIntValue());
+        }
+        return values;
+    }
+
+    void printResult(const juce::String& mode, int voices, double sampleRate, const RenderResult& result)
+    {
+        std::cout << mode.paddedRight(' ', 10)
+                  << juce::String(voices).paddedLeft(' ', 7)
+                  << juce::String((int)sampleRate).paddedLeft(' ', 8)
+                  << juce::String(result.audioSeconds, 2).paddedLeft(' ', 10)
+                  << juce::String(result.wallSeconds, 3).paddedLeft(' ', 10)
+                  << juce::String(result.getRealtimeFactor(), 1).paddedLeft(' ', 10)
+                  << juce::String(juce::Decibels::gainToDecibels(result.peak), 1).paddedLeft(' ', 9)
+                  << std::endl;
+    }
+
+    void printHeader()
+    {
+        std::cout << "mode        voices    rate   audio[s]   cpu[s]  realtime  peak[dB]" << std::endl;
+    }
+
+    int runBenchmark(const RenderSettings& base, const juce::ArgumentList& args)
+    {
+        std::vector<OscMode> modes;
+        auto modeList = args.getValueForOption("--modes");
+
+        if (modeList.isEmpty() || modeList.equalsIgnoreCase("all")) {
+            for (int i = 0; i < (int)OscMode::Count; ++i) modes.push_back((OscMode)i);
+        }
+        else {
+            for (auto& name : juce::StringArray::fromTokens(modeList, ",", "")) {
+                auto mode = RenderCore::parseMode(name);
+                if (!mode.has_value()) {
+                    std::cerr << "unknown mode: " << name << std::endl;
+                    return 1;
+                }
+                modes.push_back(*mode);
+            }
+        }
+
+        auto voiceCounts = parseIntList(args.getValueForOption("--voices"));
+        if (voiceCounts.empty()) voiceCounts = { 1, 8, 16 };
+
+        auto rates = parseIntList(args.getValueForOption("--rates"));
+        if (rates.empty()) rates = { (int)base.sampleRate };
+
+        printHeader();
+
+        for (auto mode : modes) {
+            for (auto voices : voiceCounts) {
+                for (auto rate : rates) {
+                    auto settings = base;
+                    settings.mode = mode;
+                    settings.voices = voices;
+                    settings.sampleRate = (double)rate;
+
+                    auto result = RenderCore::render(settings, nullptr, nullptr);
+                    if (result.error.isNotEmpty()) {
+                        std::cerr << result.error << std::endl;
+                        return 1;
+                    }
+
+                    printResult(getModeName(mode), voices, settings.sampleRate, result);
+                }
+            }
+        }
+
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "usage: 2686VRender [--preset file.xml] [--midi file.mid] [--out file.wav] [--mode name]" << std::endl
+                  << "                   [--rate hz] [--block n] [--voices n] [--seconds sec]" << std::endl
+                  << "       2686VRender --bench [--preset file.xml] [--modes all|OPNA,...] [--voices 1,8,16] [--rates 44100,...]" << std::endl
+                  << "       2686VRender --golden dir --corpus dir [--update] [--compare bitexact|rms|spectral] [--tolerance value]" << std::endl;
+        return 0;
+    }
+
+    RenderSettings settings;
+
+    if (args.containsOption("--preset")) settings.presetFile = args.getFileForOption("--preset");
+    if (args.containsOption("--midi")) settings.midiFile = args.getFileForOption("--midi");
+
+    for (const auto& file : { settings.presetFile, settings.midiFile })
+    {
+        if (file != juce::File() && !file.existsAsFile()) {
+            std::cerr << "file not found: " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    if (args.containsOption("--out")) settings.outFile = args.getFileForOption("--out");
+    if (args.containsOption("--rate")) settings.sampleRate = args.getValueForOption("--rate").getDoubleValue();
+    if (args.containsOption("--block")) settings.blockSize = std::max(1, args.getValueForOption("--block").getIntValue());
+    if (args.containsOption("--seconds")) settings.seconds = args.getValueForOption("--seconds").getDoubleValue();
+
+    if (args.containsOption("--voices") && !args.containsOption("--bench")) settings.voices = std::max(1, args.getValueForOption("--voices").getIntValue());
+
+    if (args.containsOption("--bench")) return runBenchmark(settings, args);
+    if (args.containsOption("--golden")) return RenderGolden::run(settings, args);
+
+    if (args.containsOption("--mode"))
+    {
+        settings.mode = RenderCore::parseMode(args.getValueForOption("--mode"));
+        if (!settings.mode.has_value()) {
+            std::cerr << "unknown mode: " << args.getValueForOption("--mode") << std::endl;
+            return 1;
+        }
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    if (settings.outFile != juce::File())
+    {
+        writer = RenderCore::createWavWriter(settings.outFile, settings.sampleRate, 24);
+        if (writer == nullptr) {
+            std::cerr << "cannot write: " << settings.outFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    auto result = RenderCore::render(settings, writer.get(), nullptr);
+    writer.reset();
+
+    if (result.error.isNotEmpty()) {
+        std::cerr << result.error << std::endl;
+        return 1;
+    }
+
+    printHeader();
+    printResult(settings.mode.has_value() ? getModeName(*settings.mode) : juce::String("(preset)"), settings.voices, settings.sampleRate, result);
+
+    return 0;
+}